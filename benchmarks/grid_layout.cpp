@@ -0,0 +1,74 @@
+// grid_layout_manager with 10k children in a 100 by 100 grid: adding
+// them, relayout passes at changing bounds, and removing them all in
+// shuffled order.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <native.h>
+
+using namespace native;
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr int side = 100;
+    constexpr int cells = side * side;
+
+    struct leaf : wnd
+    {
+        leaf() : wnd(0, 0, 10, 10) {}
+        void show() const override {}
+        void create() const override {}
+        void destroy() const override {}
+    };
+
+    double ms_since(clock_type::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(clock_type::now() - t0).count();
+    }
+}
+
+int program(int, char **)
+{
+    std::vector<std::unique_ptr<leaf>> leaves;
+    for (int i = 0; i < cells; ++i)
+        leaves.emplace_back(new leaf());
+
+    leaf host;
+    grid_layout_manager grid(side, side);
+
+    auto t0 = clock_type::now();
+    for (int i = 0; i < cells; ++i)
+        grid.add(*leaves[i], i / side, i % side);
+    std::printf("add %d children      %8.2f ms\n", cells, ms_since(t0));
+
+    // Every pass changes the bounds, so every child is moved.
+    const int passes = 100;
+    t0 = clock_type::now();
+    for (int i = 0; i < passes; ++i)
+        grid.relayout(&host, rect(0, 0, static_cast<dim>(2000 + i), static_cast<dim>(2000 + i)));
+    std::printf("relayout, resizing      %8.2f ms/pass\n", ms_since(t0) / passes);
+
+    // Same bounds again: no child moves.
+    t0 = clock_type::now();
+    for (int i = 0; i < passes; ++i)
+        grid.relayout(&host, rect(0, 0, static_cast<dim>(2000 + passes - 1), static_cast<dim>(2000 + passes - 1)));
+    std::printf("relayout, unchanged     %8.2f ms/pass\n", ms_since(t0) / passes);
+
+    std::vector<int> order(cells);
+    for (int i = 0; i < cells; ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+
+    t0 = clock_type::now();
+    for (int i : order)
+        grid.remove_child(leaves[i].get());
+    std::printf("remove %d, shuffled   %8.2f ms (%zu left)\n", cells, ms_since(t0), grid.children().size());
+    return 0;
+}
@@ -0,0 +1,63 @@
+// static_grid<4, 4> against grid_layout_manager(4, 4) with the same 16
+// children, spans and margins: relayout passes at changing bounds and
+// at the same bounds.
+
+#include <chrono>
+#include <cstdio>
+
+#include <native.h>
+
+using namespace native;
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr int passes = 2000000;
+
+    struct leaf : wnd
+    {
+        leaf() : wnd(0, 0, 1, 1) {}
+        void show() const override {}
+        void create() const override {}
+        void destroy() const override {}
+    };
+
+    // Runs passes relayouts of l; resizing changes the width every pass.
+    double ns_per_pass(layout_manager &l, wnd &host, bool resizing)
+    {
+        const auto t0 = clock_type::now();
+        for (int i = 0; i < passes; ++i)
+        {
+            const int w = 300 + (resizing ? (i & 63) : 0);
+            l.relayout(&host, rect(0, 0, static_cast<dim>(w), 200));
+        }
+        return std::chrono::duration<double, std::nano>(clock_type::now() - t0).count() / passes;
+    }
+}
+
+int program(int, char **)
+{
+    leaf host;
+    leaf a[16];
+    leaf b[16];
+
+    grid_layout_manager dynamic(4, 4);
+    static_grid<4, 4> fixed;
+    for (int i = 0; i < 16; ++i)
+    {
+        const int row_span = i % 3 == 0 && i < 12 ? 2 : 1;
+        const int column_span = i % 5 == 0 && i % 4 < 3 ? 2 : 1;
+        dynamic.add(a[i], i / 4, i % 4, row_span, column_span, i % 2);
+        fixed.add(b[i], i / 4, i % 4, row_span, column_span, i % 2);
+    }
+
+    for (bool resizing : {true, false})
+    {
+        const double s = ns_per_pass(fixed, host, resizing);
+        const double d = ns_per_pass(dynamic, host, resizing);
+        std::printf("%-10s static_grid %7.1f ns/pass  grid_layout_manager %7.1f ns/pass  (%.1fx)\n",
+                    resizing ? "resizing" : "unchanged", s, d, d / s);
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <native.h>
+#include <algorithm>
 #include <vector>
 
 class painter_window : public native::app_wnd
@@ -11,10 +12,19 @@ public:
         on_mouse_move.connect(this, &painter_window::on_move);
         on_mouse_wheel.connect(this, &painter_window::on_wheel);
         on_wnd_paint.connect(this, &painter_window::on_paint);
+
+        // Keep every raw motion sample so fast strokes stay smooth.
+        set_motion_history(true);
+
+        // Where the backend keeps the backbuffer, strokes already painted
+        // stay there and each motion only paints its new segments.
+        set_preserve_contents(true);
     }
 
 private:
     std::vector<std::vector<native::point>> _strokes;
+    std::vector<native::line> _pending;
+    native::rect _damage;
     bool _drawing;
 
     // Left mouse down starts a stroke; left mouse up ends it.
@@ -31,19 +41,26 @@ private:
             {
                 _drawing = false;
             }
-            invalidate();
         }
         return true;
     }
 
-    // Track mouse motion during a stroke.
-    bool on_move(native::point p)
+    // Track mouse motion during a stroke. Motion is coalesced, so take
+    // all samples since the last call rather than just the latest point.
+    bool on_move(native::point)
     {
-        if (_drawing)
+        if (!_drawing)
+            return true;
+
+        for (const auto &sample : motion_history())
         {
-            _strokes.back().push_back(p);
-            invalidate();
+            native::point from = _strokes.back().back();
+            _strokes.back().push_back(sample.position);
+            _pending.push_back(native::line(from, sample.position));
+            _damage = grow(_damage, from, sample.position);
         }
+
+        invalidate(_damage);
         return true;
     }
 
@@ -51,21 +68,56 @@ private:
     bool on_wheel(native::mouse_wheel_event)
     {
         _strokes.clear();
+        _pending.clear();
         _drawing = false;
         invalidate();
         return true;
     }
 
-    // Paint all strokes.
+    // Paint new segments only, unless something else (first show, resize,
+    // clear) damaged the window or the backend cleared the area; then
+    // repaint all strokes in the area.
     bool on_paint(native::wnd_paint_event e)
     {
-        for (const auto &stroke : _strokes)
+        const bool only_new = contents_retained() && !_pending.empty() &&
+                              e.r.p.x == _damage.p.x && e.r.p.y == _damage.p.y &&
+                              e.r.d.w == _damage.d.w && e.r.d.h == _damage.d.h;
+
+        if (only_new)
         {
-            for (size_t i = 1; i < stroke.size(); ++i)
-                e.g.draw_line(stroke[i - 1], stroke[i]);
+            for (const auto &segment : _pending)
+                e.g.draw_line(segment.a, segment.b);
         }
+        else
+        {
+            e.g.clear(native::rgba(255, 255, 255, 255));
+            for (const auto &stroke : _strokes)
+            {
+                for (size_t i = 1; i < stroke.size(); ++i)
+                    e.g.draw_line(stroke[i - 1], stroke[i]);
+            }
+        }
+
+        _pending.clear();
+        _damage = native::rect();
         return true;
     }
+
+    // Grow r to cover the segment a-b, one pixel past each end.
+    static native::rect grow(native::rect r, native::point a, native::point b)
+    {
+        int x1 = std::min(a.x, b.x), y1 = std::min(a.y, b.y);
+        int x2 = std::max(a.x, b.x) + 1, y2 = std::max(a.y, b.y) + 1;
+        if (r.d.w > 0 && r.d.h > 0)
+        {
+            x1 = std::min<int>(x1, r.x1());
+            y1 = std::min<int>(y1, r.y1());
+            x2 = std::max<int>(x2, r.x2());
+            y2 = std::max<int>(y2, r.y2());
+        }
+        return native::rect(static_cast<native::coord>(x1), static_cast<native::coord>(y1),
+                            static_cast<native::dim>(x2 - x1), static_cast<native::dim>(y2 - y1));
+    }
 };
 
 int program(int argc, char *argv[])
@@ -4,7 +4,14 @@
 #include <vector>
 #include <memory>
 #include <functional>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <mutex>
 #include <utility>
 #include <cstdint>
 
@@ -90,6 +97,119 @@ namespace native
     };
 
     // --- Signals. --------------------------------------------------
+    namespace detail
+    {
+        // Move-only callable that stores small targets (lambdas with a few
+        // captures, member function thunks, std::function) inline and
+        // only puts larger ones on the heap.
+        template <typename Signature>
+        class inline_fn;
+
+        template <typename R, typename... A>
+        class inline_fn<R(A...)>
+        {
+        public:
+            static constexpr std::size_t capacity = 4 * sizeof(void *);
+
+            inline_fn() = default;
+
+            template <typename F, typename D = std::decay_t<F>,
+                      typename = std::enable_if_t<!std::is_same<D, inline_fn>::value>>
+            inline_fn(F &&f)
+            {
+                if constexpr (fits<D>())
+                {
+                    ::new (static_cast<void *>(_buf)) D(std::forward<F>(f));
+                    _ops = &inline_ops<D>;
+                }
+                else
+                {
+                    *reinterpret_cast<D **>(_buf) = new D(std::forward<F>(f));
+                    _ops = &heap_ops<D>;
+                }
+            }
+
+            inline_fn(inline_fn &&other) noexcept { take(other); }
+
+            inline_fn &operator=(inline_fn &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    take(other);
+                }
+                return *this;
+            }
+
+            inline_fn(const inline_fn &) = delete;
+            inline_fn &operator=(const inline_fn &) = delete;
+
+            ~inline_fn() { reset(); }
+
+            explicit operator bool() const { return _ops != nullptr; }
+
+            // Arguments are passed on as lvalues, so one set of values can
+            // be handed to several targets in turn.
+            R operator()(A &...args) { return _ops->call(_buf, args...); }
+
+            void reset()
+            {
+                if (_ops)
+                {
+                    _ops->destroy(_buf);
+                    _ops = nullptr;
+                }
+            }
+
+        private:
+            struct ops
+            {
+                R (*call)(void *self, A &...args);
+                void (*move)(void *to, void *from);
+                void (*destroy)(void *self);
+            };
+
+            template <typename D>
+            static constexpr bool fits()
+            {
+                return sizeof(D) <= capacity &&
+                       alignof(D) <= alignof(std::max_align_t) &&
+                       std::is_nothrow_move_constructible<D>::value;
+            }
+
+            template <typename D>
+            static constexpr ops inline_ops = {
+                [](void *self, A &...args) -> R { return (*static_cast<D *>(self))(args...); },
+                [](void *to, void *from)
+                {
+                    ::new (to) D(std::move(*static_cast<D *>(from)));
+                    static_cast<D *>(from)->~D();
+                },
+                [](void *self) { static_cast<D *>(self)->~D(); }};
+
+            template <typename D>
+            static constexpr ops heap_ops = {
+                [](void *self, A &...args) -> R { return (**static_cast<D **>(self))(args...); },
+                [](void *to, void *from) { *static_cast<D **>(to) = *static_cast<D **>(from); },
+                [](void *self) { delete *static_cast<D **>(self); }};
+
+            void take(inline_fn &other) noexcept
+            {
+                _ops = other._ops;
+                if (_ops)
+                {
+                    _ops->move(_buf, other._buf);
+                    other._ops = nullptr;
+                }
+            }
+
+            alignas(std::max_align_t) unsigned char _buf[capacity];
+            const ops *_ops = nullptr;
+        };
+    }
+
+    // Not synchronized: one signal is connected, disconnected and emitted
+    // from one thread at a time. Separate signals share no state.
     template <typename... Args>
     class signal
     {
@@ -99,10 +219,15 @@ namespace native
         explicit signal(std::function<void()> init)
             : current_id(0), initialized(false), initializer(std::move(init)) {}
 
-        int connect(const std::function<bool(Args...)> &slot) const
+        // Slots connected while the signal is emitting are held aside and
+        // join after the outermost emit returns, so they first run on the
+        // next emit.
+        template <typename F>
+        int connect(F &&slot) const
         {
             ensure_init();
-            slots[++current_id] = slot;
+            auto &into = emitting ? pending : slots;
+            into.push_back(entry{++current_id, true, slot_fn(std::forward<F>(slot))});
             return current_id;
         }
 
@@ -120,27 +245,92 @@ namespace native
                            { return (instance->*method)(std::forward<Args>(args)...); });
         }
 
+        // Safe from inside a slot, including the slot's own id: during an
+        // emit the slot is only marked dead and removed afterwards.
         void disconnect(int id) const
         {
-            slots.erase(id);
+            if (id <= 0)
+                return;
+
+            if (remove(pending, id))
+                return;
+
+            auto it = std::lower_bound(slots.begin(), slots.end(), id,
+                                       [](const entry &e, int key) { return e.id < key; });
+            if (it == slots.end() || it->id != id || !it->live)
+                return;
+
+            if (emitting)
+            {
+                it->live = false;
+                ++dead;
+            }
+            else
+            {
+                slots.erase(it);
+            }
         }
 
         void disconnect_all() const
         {
-            slots.clear();
+            pending.clear();
+            if (emitting)
+            {
+                for (auto &e : slots)
+                    e.live = false;
+                dead = slots.size();
+            }
+            else
+            {
+                slots.clear();
+            }
+        }
+
+        bool empty() const
+        {
+            return slots.size() == dead && pending.empty();
         }
 
+        // Slots run newest first; the first one to return true stops the
+        // dispatch.
         void emit(Args... args)
         {
             ensure_init();
-            for (auto it = slots.rbegin(); it != slots.rend(); ++it)
+
+            emit_scope scope(*this);
+            for (std::size_t i = slots.size(); i-- > 0;)
             {
-                if (it->second(std::forward<Args>(args)...))
+                if (slots[i].live && slots[i].fn(args...))
                     break;
             }
         }
 
     private:
+        using slot_fn = detail::inline_fn<bool(Args...)>;
+
+        // Ids only grow, so both vectors stay sorted by id.
+        struct entry
+        {
+            int id;
+            bool live; // false once disconnected during an emit
+            slot_fn fn;
+        };
+
+        // Tracks emit nesting and tidies up when the outermost one ends,
+        // including when a slot throws.
+        struct emit_scope
+        {
+            const signal &s;
+
+            explicit emit_scope(const signal &sig) : s(sig) { ++s.emitting; }
+
+            ~emit_scope()
+            {
+                if (--s.emitting == 0)
+                    s.settle();
+            }
+        };
+
         void ensure_init() const
         {
             if (!initialized && initializer)
@@ -150,12 +340,199 @@ namespace native
             }
         }
 
-        mutable std::map<int, std::function<bool(Args...)>> slots;
+        static bool remove(std::vector<entry> &from, int id)
+        {
+            for (auto it = from.begin(); it != from.end(); ++it)
+            {
+                if (it->id == id)
+                {
+                    from.erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void settle() const
+        {
+            if (dead)
+            {
+                slots.erase(std::remove_if(slots.begin(), slots.end(),
+                                           [](const entry &e) { return !e.live; }),
+                            slots.end());
+                dead = 0;
+            }
+
+            if (!pending.empty())
+            {
+                for (auto &e : pending)
+                    slots.push_back(std::move(e));
+                pending.clear();
+            }
+        }
+
+        mutable std::vector<entry> slots;
+        mutable std::vector<entry> pending;
+        mutable std::size_t dead = 0;
+        mutable int emitting = 0;
         mutable int current_id;
         mutable bool initialized;
         std::function<void()> initializer;
     };
 
+    // --- Signal adapters. ------------------------------------------
+    namespace detail
+    {
+        // Base for adapters whose output is delivered by the main loop.
+        // Registered with the frame scheduler for its whole lifetime; the
+        // loop calls fire() once the scheduled time has passed.
+        class deferred
+        {
+        public:
+            deferred(const deferred &) = delete;
+            deferred &operator=(const deferred &) = delete;
+
+            bool pending() const { return _pending; }
+            uint64_t due() const { return _due; }
+
+            void fire(uint64_t now_ms)
+            {
+                _pending = false;
+                deliver(now_ms);
+            }
+
+            // Same clock as app::on_frame, in milliseconds.
+            static uint64_t now_ms();
+
+        protected:
+            deferred();
+            virtual ~deferred();
+
+            void schedule(uint64_t due_ms)
+            {
+                _due = due_ms;
+                _pending = true;
+            }
+
+            virtual void deliver(uint64_t now_ms) = 0;
+
+        private:
+            uint64_t _due = 0;
+            bool _pending = false;
+        };
+
+        // Holds the latest value of source until the main loop delivers
+        // it. Connecting allocates; later emits of source do not.
+        template <typename... Args>
+        class signal_adapter : public signal<Args...>, private deferred
+        {
+        public:
+            ~signal_adapter() override { _source.disconnect(_id); }
+
+        protected:
+            explicit signal_adapter(const signal<Args...> &source)
+                : _source(source),
+                  _id(source.connect([this](Args... args)
+                                     {
+                                         _latest.emplace(args...);
+                                         arrived(now_ms());
+                                         return false;
+                                     }))
+            {
+            }
+
+            // A new value is stored; decide when to deliver it.
+            virtual void arrived(uint64_t now_ms) = 0;
+
+            using deferred::now_ms;
+            using deferred::pending;
+            using deferred::schedule;
+
+            void deliver(uint64_t) override
+            {
+                if (!_latest)
+                    return;
+
+                auto value = std::move(*_latest);
+                _latest.reset();
+                std::apply([this](auto &...args) { this->emit(args...); }, value);
+            }
+
+        private:
+            const signal<Args...> &_source;
+            std::optional<std::tuple<std::decay_t<Args>...>> _latest;
+            int _id;
+        };
+    }
+
+#ifdef NATIVE_FRAME_SCHEDULER
+    // The adapters below are delivered by the frame scheduler, which only
+    // the X11, SDL2 and Motif loops run. Other backends do not define
+    // NATIVE_FRAME_SCHEDULER, so using an adapter there fails to compile
+    // rather than never firing.
+
+    // Re-emits only the latest value of source, at most once per main loop
+    // iteration. The source must outlive the adapter:
+    //
+    //   native::coalesced resized(w.on_wnd_resize);
+    //   resized.connect([](native::size s) { relayout(s); return false; });
+    template <typename... Args>
+    class coalesced : public detail::signal_adapter<Args...>
+    {
+    public:
+        explicit coalesced(const signal<Args...> &source)
+            : detail::signal_adapter<Args...>(source) {}
+
+    private:
+        void arrived(uint64_t now_ms) override { this->schedule(now_ms); }
+    };
+
+    // Re-emits the latest value of source at most once per interval_ms.
+    // The first value after a quiet period goes out on the next loop
+    // iteration; values arriving within the interval are folded into one
+    // trailing delivery.
+    template <typename... Args>
+    class throttled : public detail::signal_adapter<Args...>
+    {
+    public:
+        throttled(const signal<Args...> &source, int interval_ms)
+            : detail::signal_adapter<Args...>(source),
+              _interval(static_cast<uint64_t>(interval_ms > 0 ? interval_ms : 0)) {}
+
+    private:
+        void arrived(uint64_t now_ms) override
+        {
+            if (!this->pending())
+                this->schedule(std::max(now_ms, _last + _interval));
+        }
+
+        void deliver(uint64_t now_ms) override
+        {
+            _last = now_ms;
+            detail::signal_adapter<Args...>::deliver(now_ms);
+        }
+
+        uint64_t _interval;
+        uint64_t _last = 0;
+    };
+
+    // Re-emits the latest value of source once it has been quiet for
+    // delay_ms.
+    template <typename... Args>
+    class debounced : public detail::signal_adapter<Args...>
+    {
+    public:
+        debounced(const signal<Args...> &source, int delay_ms)
+            : detail::signal_adapter<Args...>(source),
+              _delay(static_cast<uint64_t>(delay_ms > 0 ? delay_ms : 0)) {}
+
+    private:
+        void arrived(uint64_t now_ms) override { this->schedule(now_ms + _delay); }
+
+        uint64_t _delay;
+    };
+#endif
+
     // --- Events. ---------------------------------------------------
     enum class mouse_button
     {
@@ -201,6 +578,16 @@ namespace native
             : position(pos), delta(d), direction(dir) {}
     };
 
+    struct motion_sample
+    {
+        point position;
+        uint32_t time = 0; // Native event timestamp in milliseconds
+
+        motion_sample() = default;
+        motion_sample(point pos, uint32_t t)
+            : position(pos), time(t) {}
+    };
+
     // --- Fonts. ----------------------------------------------------
     enum class font_role
     {
@@ -267,15 +654,137 @@ namespace native
         rgba *pixels() { return _data.get(); }
         const rgba *pixels() const { return _data.get(); }
 
+        // Shared painter for this image, created on first use.
+        // Creation is thread-safe; drawing through it is not, because
+        // ink, pen and clip live in the one shared object.
         gpx &get_gpx() const;
 
+        // Independent software painter for this image. Needs no display
+        // or application; create one per thread to render disjoint
+        // images (or disjoint clip regions of one image) concurrently.
+        std::unique_ptr<gpx> create_gpx() const;
+
     private:
         coord _w, _h;
         std::unique_ptr<rgba[]> _data;
         mutable std::unique_ptr<gpx> _gpx;
+        mutable std::once_flag _gpx_once;
+    };
+
+    // --- Paths. ----------------------------------------------------
+    enum class fill_rule
+    {
+        nonzero,
+        even_odd
+    };
+
+    // Outline made of lines, quadratic and cubic Beziers and circular
+    // arcs, in float pixel coordinates. Curves are flattened into line
+    // segments as they are added, to within tolerance pixels, so every
+    // painter only sees polygons.
+    class path
+    {
+    public:
+        static constexpr float tolerance = 0.25f;
+
+        struct vertex
+        {
+            float x;
+            float y;
+        };
+
+        // A run of vertices; closed contours end with an edge back to the
+        // first vertex.
+        struct contour
+        {
+            std::size_t first;
+            std::size_t count;
+            bool closed;
+        };
+
+        path &move_to(float x, float y);
+        path &line_to(float x, float y);
+        path &quad_to(float cx, float cy, float x, float y);
+        path &cubic_to(float c1x, float c1y, float c2x, float c2y, float x, float y);
+
+        // Arc of the circle around (cx, cy), from angle start through
+        // sweep, in radians; positive sweeps turn clockwise on screen. A
+        // line joins it to the current point, if there is one.
+        path &arc(float cx, float cy, float radius, float start, float sweep);
+
+        path &close();
+        path &clear();
+
+        bool empty() const;
+        const std::vector<vertex> &vertices() const;
+        const std::vector<contour> &contours() const;
+
+    private:
+        void add(float x, float y);
+
+        std::vector<vertex> _vertices;
+        std::vector<contour> _contours;
+        bool _open = false; // Last contour takes more vertices
+    };
+
+    // --- Gradients. ------------------------------------------------
+    enum class gradient_kind
+    {
+        linear,
+        radial
+    };
+
+    // Colour ramp for gpx::fill_rect_gradient(). A linear gradient runs
+    // across the rect at angle radians, 0 being left to right and pi / 2
+    // top to bottom. A radial one runs from the centre of the rect out to
+    // the ellipse that touches its sides. The ramp is sampled into a
+    // 256-entry table when the gradient is made, so keep gradients around
+    // rather than building one per paint.
+    class gradient
+    {
+    public:
+        struct stop
+        {
+            float at; // 0 to 1
+            rgba color;
+        };
+
+        gradient(gradient_kind kind, std::vector<stop> stops, float angle = 1.57079633f);
+
+        gradient_kind kind() const;
+        float angle() const;
+        const std::vector<stop> &stops() const;
+
+        // Entry i is the colour at i / 255.
+        const rgba *table() const;
+
+        // Never shared by two gradients; backends key uploads on it.
+        uint64_t serial() const;
+
+        // The gradient over a w x h rect, rendered on first use and kept
+        // until another size is asked for. Not thread-safe.
+        const img &image(dim w, dim h) const;
+
+    private:
+        gradient_kind _kind;
+        float _angle;
+        std::vector<stop> _stops;
+        rgba _table[256];
+        uint64_t _serial;
+        mutable std::unique_ptr<img> _image;
     };
 
     // --- Graphics --------------------------------------------------
+    // How the ends of lines wider than one pixel are drawn: flush with
+    // the end points, squared off half the pen past them, or rounded.
+    enum class line_cap
+    {
+        butt,
+        square,
+        round
+    };
+
+    class series_pyramid; // forward declare
     class gpx
     {
     public:
@@ -290,6 +799,9 @@ namespace native
         gpx &set_pen(const uint8_t thickness);
         uint8_t pen() const;
 
+        gpx &set_cap(const line_cap c);
+        line_cap cap() const;
+
         gpx &set_font(const font_t &f);
         const font_t &font() const;  // returns set font, or stock(system) if none set
 
@@ -302,13 +814,94 @@ namespace native
         virtual gpx &draw_text(const std::string &text, point p) = 0;
         virtual gpx &draw_img(const img &src, point dst) = 0;
 
+        // Copies src to dst within the same surface. Overlap is safe;
+        // only the part of the destination inside the clip is written.
+        virtual gpx &copy_area(const rect &src, point dst) = 0;
+
+        // Fills p with the current ink. Image painters cover the edges
+        // anti-aliased. The defaults, for painters without a polygon
+        // primitive, fill whole pixels with draw_rect() and stroke with
+        // draw_line().
+        virtual gpx &fill_path(const path &p, fill_rule rule = fill_rule::nonzero);
+
+        // Strokes every contour of p with the current ink and pen.
+        virtual gpx &draw_path(const path &p);
+
+        // Fills r with g. The defaults draw a horizontal or vertical
+        // linear gradient as one draw_rect() per band of equal colour, and
+        // blit any other from g.image().
+        virtual gpx &fill_rect_gradient(const rect &r, const gradient &g);
+
+        // Fills r with copies of tile laid out from origin, so that
+        // neighbouring fills line up. The default blits whole tiles and
+        // cropped copies at the edges.
+        virtual gpx &fill_rect_pattern(const rect &r, const img &tile, point origin = {0, 0});
+
+        // Stretches src over dst as a nine-slice. center is the part of
+        // src that stretches both ways; the corners around it are copied
+        // as they are and the edges stretch along their length only. A
+        // dst narrower than both corners drops the middle and shares the
+        // width between them. The default scales the visible part in
+        // software and blits it with draw_img().
+        virtual gpx &draw_img_nine_slice(const img &src, const rect &center, const rect &dst);
+
+        // Plots the samples ys[0, n) as a line in r with the current ink,
+        // one pixel column at a time. Column c shows the samples from
+        // x0 + c * dx up to x0 + (c + 1) * dx, and y_lo and y_hi map to
+        // the bottom and top of r. A column is one vertical line from the
+        // min to the max of its samples and the sample before them, so
+        // the cost follows r.w, not the number of samples. With a pyramid
+        // over the same samples, the min and max are looked up in it.
+        // Samples outside [y_lo, y_hi] are pinned to the edge, and nothing
+        // is drawn outside r whatever the pen.
+        gpx &draw_series(const float *ys, std::size_t n, double x0, double dx,
+                         const rect &r, float y_lo, float y_hi,
+                         const series_pyramid *pyramid = nullptr);
+
     protected:
         rgba _ink    = rgba(0, 0, 0, 255);      // black
         rgba _paper  = rgba(255, 255, 255, 255); // white
         uint8_t _thickness = 1;
+        line_cap _cap = line_cap::butt;
         const font_t *_font = nullptr;           // non-owning; nullptr = use stock system
     };
 
+    // --- Series. ---------------------------------------------------
+    // Min/max pyramid over a growing array of samples, for draw_series().
+    // Level 0 keeps the min and max of every 16 samples, and each level
+    // above combines 4 blocks of the one below. That costs one float per
+    // 6 samples, and the min and max of any range take O(levels) steps.
+    // The samples stay with the caller; only whole blocks are stored.
+    class series_pyramid
+    {
+    public:
+        struct extent
+        {
+            float lo;
+            float hi;
+        };
+
+        // Brings the pyramid up to date with ys[0, n). Samples it already
+        // covers must not have changed, so appending costs O(new samples).
+        // A smaller n starts over.
+        void update(const float *ys, std::size_t n);
+        void clear();
+
+        // Samples covered so far.
+        std::size_t size() const;
+
+        // Min and max of ys[first, last), which must not be empty. ys is
+        // read only around the ends of the range.
+        extent range(const float *ys, std::size_t first, std::size_t last) const;
+
+    private:
+        static constexpr std::size_t block = 16;
+        static constexpr std::size_t fanout = 4;
+
+        std::vector<std::vector<extent>> _levels;
+        std::size_t _size = 0;
+    };
+
     // --- Native control painter. ----------------------------------
     class control_paint
     {
@@ -327,6 +920,7 @@ namespace native
             int menu_item_height = 20;
             int popup_width = 180;
             int text_padding_x = 8;
+            int button_height = 28;
         };
 
         struct palette
@@ -354,6 +948,17 @@ namespace native
         metrics defaults() const;
         static palette native_palette();
 
+        // Skins: while on, buttons and menu and list item backgrounds are
+        // drawn from the palette once per state and size class into a
+        // small image, which is then stretched to each control with
+        // draw_img_nine_slice(); only labels are drawn live. Backends
+        // that paint controls natively keep doing so. Off by default.
+        // Skins keep the palette they were drawn with, so call
+        // invalidate_skins() when it changes.
+        static void use_skins(bool on);
+        static bool skins();
+        static void invalidate_skins();
+
         control_paint &draw_button_face(const rect &r, const state &s);
         control_paint &draw_button_frame(const rect &r, const state &s);
         control_paint &draw_button_text(const rect &r,
@@ -395,6 +1000,11 @@ namespace native
         }
 
     private:
+        control_paint &draw_button_label(const rect &r,
+                                         const std::string &text,
+                                         const state &s,
+                                         const palette &p);
+
         gpx &_g;
     };
 
@@ -437,6 +1047,27 @@ namespace native
 
         static app_wnd *main_wnd(); // Expose current main window
 
+        // Frame pacing. invalidate() requests are coalesced and each dirty
+        // window is painted at most once per frame, when the event queue
+        // is drained. The default is 60 frames per second; 0 paints as
+        // soon as the queue is empty, without pacing.
+        static void set_frame_rate(int fps);
+        static int frame_rate();
+
+        // Emitted once per frame, before windows are painted, with a
+        // monotonic timestamp in milliseconds. While anything is connected
+        // frames keep ticking, so animations can invalidate from here.
+        static inline signal<uint64_t> on_frame;
+
+        // Layout transactions. Between begin_update() and end_update(),
+        // moving or resizing a window updates bounds() at once but defers
+        // its layout and native geometry. The outermost end_update() runs
+        // each pending layout once, parents first, then pushes the changed
+        // geometry to the toolkit with a single flush. Calls nest. Native
+        // geometry is deferred by X11 and Motif; SDL2 defers layouts.
+        static void begin_update();
+        static void end_update();
+
         // Static arguments and environment
         static inline int argc = 0;
         static inline char **argv = nullptr;
@@ -444,6 +1075,7 @@ namespace native
 
     private:
         static inline app_wnd *_main_wnd = nullptr;
+        static inline int _frame_rate = 60;
     };
 
     // --- Events. ---------------------------------------------------
@@ -456,6 +1088,35 @@ namespace native
             : r(rect), g(gpx) {}
     };
 
+    // --- Layer. ----------------------------------------------------
+    // Offscreen cache for a piece of paint output. on_paint renders into
+    // the layer's image on first use and after invalidate(); otherwise
+    // draw() just composites the image. Works with any gpx.
+    class layer
+    {
+    public:
+        layer(dim w, dim h);
+
+        void invalidate();
+        bool valid() const;
+
+        // Drops the contents; the next draw() renders again.
+        void resize(dim w, dim h);
+        size dimensions() const;
+
+        // The rendered image, rendering first if needed.
+        const img &image();
+
+        // Composites the layer at dst.
+        gpx &draw(gpx &g, point dst);
+
+        signal<wnd_paint_event> on_paint;
+
+    private:
+        std::unique_ptr<img> _img;
+        bool _valid = false;
+    };
+
     // --- Menu. -----------------------------------------------------
     class menu_items_proxy
     {
@@ -600,6 +1261,49 @@ namespace native
         // toolkit resize commands back to the OS.
         void on_native_resize(const size &s);
 
+        // Pointer motion is coalesced: on_mouse_move fires once per batch
+        // of queued motion, with the latest position. With history enabled,
+        // motion_history() holds every raw sample of that batch, oldest
+        // first, while on_mouse_move runs.
+        wnd &set_motion_history(bool enabled);
+        const std::vector<motion_sample> &motion_history() const;
+
+        // Backend callbacks for pointer motion. on_native_motion queues one
+        // sample; flush_native_motion emits on_mouse_move for the queue.
+        void on_native_motion(point p, uint32_t time);
+        void flush_native_motion();
+
+        // Preserve contents: the backbuffer is kept between paints, the
+        // background is not cleared, and on_wnd_paint receives only the
+        // damaged area (the union of invalidate(rect) calls). Content drawn
+        // earlier stays on screen. Honoured by X11, SDL2 and Motif.
+        wnd &set_preserve_contents(bool enabled);
+        bool preserve_contents() const;
+
+        // True when preserve_contents() is set and this backend honours
+        // it. Paint code that only draws what changed must check this;
+        // otherwise the damaged area arrives cleared.
+        bool contents_retained() const;
+
+        // Moves the contents of r by (dx, dy) and damages only the strip
+        // that scrolls into view, so on_wnd_paint redraws just that strip.
+        // Needs retained pixels (preserve_contents() on X11, SDL2 and
+        // Motif, top-level windows on GEMix); elsewhere r is invalidated.
+        wnd &scroll(const rect &r, coord dx, coord dy);
+
+        // Cached: the last full paint is kept and recomposited on expose,
+        // resize of the parent and overlay updates; on_wnd_paint runs only
+        // after invalidate(). Honoured by X11, SDL2 and Motif.
+        wnd &set_cached(bool enabled);
+        bool cached() const;
+
+        // Windowless: a child control is drawn into its parent's
+        // backbuffer and gets its pointer events from the parent instead
+        // of owning a native window. Set before create(). Honoured by X11;
+        // SDL2 and GEMix controls are always windowless.
+        wnd &set_windowless(bool enabled);
+        bool windowless() const;
+
         virtual void show() const = 0;
         virtual void create() const = 0;
         virtual void destroy() const = 0;
@@ -608,6 +1312,14 @@ namespace native
         void set_layout(std::unique_ptr<layout_manager> layout);
         layout_manager *layout() const;
 
+        // Measure pass. desired_size() is the size the window asks of its
+        // parent's layout: measure(), memoized until invalidate_measure().
+        // Controls invalidate when their content changes, which also drops
+        // the cached sizes of the laid-out ancestors and lays them out
+        // again. Moving or resizing a window keeps the cached size.
+        size desired_size() const;
+        void invalidate_measure();
+
         gpx &get_gpx() const;
 
         signal<> on_wnd_create;
@@ -621,6 +1333,15 @@ namespace native
 
     protected:
 
+        // Lays out the children for the current size, or queues that for
+        // end_update() while a layout transaction is open.
+        void relayout();
+
+        // Content size for desired_size(). The default is the layout's
+        // measure() when the window has a layout, and the dimensions at
+        // the time of the first measure otherwise.
+        virtual size measure() const;
+
         // Utility function to
 
         // Has create() been called?
@@ -628,9 +1349,19 @@ namespace native
 
         rect _bounds;
         std::unique_ptr<layout_manager> _layout;
+        mutable size _desired;
+        mutable bool _measured = false;
         mutable gpx *_gpx = nullptr;
         wnd *_parent;
         std::vector<wnd *> _children;
+
+        bool _preserve_contents = false;
+        bool _cached = false;
+        bool _windowless = false;
+        bool _motion_history = false;
+        bool _motion_pending = false;
+        point _motion_last;
+        std::vector<motion_sample> _motion_samples;
     };
 
     class app_wnd : public wnd
@@ -680,10 +1411,371 @@ namespace native
 
         signal<> on_click;
 
+    protected:
+        // Text width plus padding, at the platform button height.
+        size measure() const override;
+
     private:
         std::string _text;
     };
 
+    // --- Immediate-mode controls. ----------------------------------
+    // Controls that exist only while they are drawn. Call them from
+    // on_wnd_paint between begin() and end(): each call hit-tests, keeps
+    // hot and pressed state under a hashed id and draws through
+    // control_paint in the same pass. Nothing is retained per control.
+    class ui
+    {
+    public:
+        // Tracks the pointer over w and invalidates w when a control's
+        // state changes. Must not outlive w.
+        explicit ui(wnd &w);
+        ~ui();
+
+        ui(const ui &) = delete;
+        ui &operator=(const ui &) = delete;
+
+        ui &begin(gpx &g);
+        ui &end();
+
+        // A control's id hashes its label within the current id scope.
+        // Controls that share a label, such as the rows of a loop, need
+        // a scope of their own.
+        ui &push_id(uint64_t id);
+        ui &push_id(const std::string &id);
+        ui &pop_id();
+
+        // True in the pass after a press and a release both landed on
+        // the button.
+        bool button(const rect &r, const std::string &text);
+
+        // A list row drawn highlighted when selected; true when clicked.
+        bool list_item(const rect &r, const std::string &text, bool selected = false);
+
+        // Id of the control under the pointer, or 0.
+        uint64_t hot() const;
+
+    private:
+        struct hit
+        {
+            uint64_t id;
+            rect bounds;
+        };
+
+        uint64_t id_of(const std::string &label) const;
+        bool interact(uint64_t id, const rect &r, control_paint::state &st);
+        uint64_t id_at(point p) const;
+        void set_hot(uint64_t id);
+        void damage(uint64_t id);
+
+        wnd &_w;
+        gpx *_g = nullptr;
+        int _move_slot = 0;
+        int _click_slot = 0;
+
+        // Pointer input is resolved against the last pass between
+        // passes, so a press and release that both arrive before the
+        // next paint still click.
+        point _mouse;
+        uint64_t _hot = 0;
+        uint64_t _active = 0;
+        uint64_t _clicked = 0;
+        std::vector<uint64_t> _ids;
+
+        // Controls drawn in the last complete pass, for hit-testing
+        // between passes, and the ones drawn in the current pass.
+        std::vector<hit> _hits;
+        std::vector<hit> _drawn;
+    };
+
+    // --- List and table views. -------------------------------------
+    // Virtualized rows drawn into a rectangle of a host window. Rows come
+    // from callbacks that are asked only for the rows being painted or
+    // hit-tested, so nothing is built per row. With fixed row heights
+    // memory does not depend on the row count. With variable heights, a
+    // prefix-sum index keeps one offset per 256 rows and grows only as
+    // far as scrolling has reached. Scrolling uses wnd::scroll(), so with
+    // preserve_contents() only the rows that scroll into view are painted.
+    class list_view
+    {
+    public:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        using count_fn = std::function<std::size_t()>;
+        using text_fn = std::function<std::string(std::size_t row)>;
+        using height_fn = std::function<dim(std::size_t row)>;
+
+        // Paints from a handler on w.on_wnd_paint and takes wheel and left
+        // clicks inside bounds. Handlers run newest first, so the view
+        // draws over handlers connected after it and under those
+        // connected before it; a view that is a member of w draws over a
+        // paint handler that w's constructor connects. Must not outlive w.
+        list_view(wnd &w, const rect &bounds);
+        virtual ~list_view();
+
+        list_view(const list_view &) = delete;
+        list_view &operator=(const list_view &) = delete;
+
+        list_view &set_source(count_fn count, text_fn text);
+
+        // Fixed height for every row (the default, at 20 pixels), or a
+        // callback for variable heights. Heights are read once per row
+        // while the index grows and again when a row is drawn.
+        list_view &set_row_height(dim h);
+        list_view &set_row_heights(height_fn height);
+
+        // Call when rows were added, removed or changed height.
+        // reload_from() keeps what is known about the rows before first,
+        // which suits a source that only grows or shrinks at the end.
+        list_view &reload();
+        list_view &reload_from(std::size_t first);
+
+        list_view &set_bounds(const rect &r);
+        rect bounds() const;
+
+        // Scroll position in pixels from the top of the first row.
+        list_view &scroll_to(int64_t y);
+        int64_t scroll_offset() const;
+
+        // Scrolls the least distance that shows row in full.
+        list_view &ensure_visible(std::size_t row);
+
+        // Row at a point of the host window, or npos.
+        std::size_t row_at(point p);
+
+        list_view &select(std::size_t row);
+        std::size_t selected() const;
+
+        // Exact once the index has reached the last row; until then it
+        // is estimated from the average height so far.
+        int64_t content_height();
+
+        signal<std::size_t> on_select;
+
+    protected:
+        // Area the rows scroll in: bounds() less any header.
+        virtual rect body() const;
+
+        // Draws one row into r, clipped to the body.
+        virtual void paint_row(gpx &g, std::size_t row, const rect &r, const control_paint::state &st);
+
+        // Called for wheel events in the horizontal direction.
+        virtual void scroll_horizontal(int dx);
+
+        virtual void paint(gpx &g);
+
+        void scroll_body(const rect &area, int dx, int dy);
+
+        wnd &_w;
+        rect _bounds;
+        count_fn _count;
+        text_fn _text;
+
+    private:
+        static constexpr std::size_t block_rows = 256;
+
+        std::size_t count() const;
+        dim height_of(std::size_t row) const;
+        int64_t row_top(std::size_t row);
+        std::size_t row_at_offset(int64_t y);
+        bool grow_index();
+        void invalidate_row(std::size_t row);
+
+        height_fn _height;
+        dim _row_height = 20;
+
+        // Variable heights: _block_top[b] is the offset of row
+        // b * block_rows, for every block the index has reached. A
+        // complete index has one more entry, the total height.
+        std::vector<int64_t> _block_top;
+        bool _index_complete = false;
+
+        int64_t _offset = 0;
+        std::size_t _selected = npos;
+
+        int _paint_slot = 0;
+        int _click_slot = 0;
+        int _wheel_slot = 0;
+    };
+
+    // list_view with columns and a header. Only the columns that
+    // intersect the view are drawn and asked for cell text; the
+    // horizontal wheel scrolls them.
+    class table_view : public list_view
+    {
+    public:
+        struct column
+        {
+            std::string title;
+            dim width = 100;
+        };
+
+        using cell_fn = std::function<std::string(std::size_t row, std::size_t column)>;
+
+        table_view(wnd &w, const rect &bounds);
+
+        table_view &set_columns(std::vector<column> columns);
+        table_view &set_source(count_fn count, cell_fn cell);
+
+        // 0 hides the header.
+        table_view &set_header_height(dim h);
+
+        table_view &scroll_columns_to(int x);
+        int column_offset() const;
+
+    protected:
+        rect body() const override;
+        void paint_row(gpx &g, std::size_t row, const rect &r, const control_paint::state &st) override;
+        void scroll_horizontal(int dx) override;
+        void paint(gpx &g) override;
+
+    private:
+        // First column intersecting [x, ...) of the column strip.
+        std::size_t column_at(int x) const;
+        int total_width() const;
+
+        std::vector<column> _columns;
+        std::vector<int> _column_left; // Prefix sums, one more than columns
+        cell_fn _cell;
+        dim _header_height = 22;
+        int _column_offset = 0;
+    };
+
+#ifdef NATIVE_FRAME_SCHEDULER
+    namespace detail
+    {
+        class text_index;
+    }
+
+    // Read-only list_view of a text file of any size, one row per line in
+    // font_role::fixed. The file is memory-mapped, and open() returns
+    // without reading it. A background thread indexes the lines, and rows
+    // appear as they are found. Memory grows with the number of lines,
+    // at 8 bytes per line, not with the size of the file. Appends are
+    // picked up while the file is open. A truncated file is indexed again
+    // from the start. Progress arrives through the frame scheduler, so
+    // text_view is only built for X11, SDL2 and Motif, and declared only
+    // where NATIVE_FRAME_SCHEDULER is defined; elsewhere code using it
+    // fails to compile instead of failing to link.
+    class text_view : public list_view, private detail::deferred
+    {
+    public:
+        text_view(wnd &w, const rect &bounds);
+        ~text_view() override;
+
+        // Returns false if path cannot be opened or mapped.
+        bool open(const std::string &path);
+        void close();
+        bool is_open() const;
+
+        // Lines found so far, and whether the index has reached the end
+        // of the file.
+        std::size_t line_count() const;
+        bool indexed() const;
+
+        // Line i without its line break.
+        std::string line(std::size_t i) const;
+
+        // Keeps the last line in view as lines are appended.
+        text_view &set_follow_tail(bool on);
+        bool follow_tail() const;
+
+    protected:
+        void paint_row(gpx &g, std::size_t row, const rect &r, const control_paint::state &st) override;
+
+    private:
+        void deliver(uint64_t now_ms) override;
+
+        std::unique_ptr<detail::text_index> _index;
+        std::size_t _lines = 0; // Rows the list_view was last reloaded with
+        uint64_t _bytes = 0;
+        uint64_t _generation = 0;
+        bool _follow = false;
+    };
+#endif
+
+    // --- Cell grid. ------------------------------------------------
+    // Terminal-style grid of character cells drawn into a rectangle of a
+    // host window in font_role::fixed. Changing a cell only sets its bit
+    // in a dirty bitset and damages the cell. When the host preserves its
+    // contents, a paint pass draws just the dirty cells. Neighbouring
+    // dirty cells with the same colours go out as one draw_text() run.
+    // Rows are a ring, so scroll() moves no cells and blits the pixels
+    // with wnd::scroll().
+    class cell_grid
+    {
+    public:
+        struct cell
+        {
+            char32_t ch = U' ';
+            rgba fg = rgba(0, 0, 0, 255);
+            rgba bg = rgba(255, 255, 255, 255);
+        };
+
+        // Paints from a handler on w.on_wnd_paint. Handlers run newest
+        // first, so the grid draws over handlers connected after it and
+        // under those connected before it. With preserve_contents(),
+        // nothing else may draw over the grid: cells that did not change
+        // are not drawn again. Must not outlive w.
+        cell_grid(wnd &w, point origin, std::size_t rows, std::size_t cols);
+        ~cell_grid();
+
+        cell_grid(const cell_grid &) = delete;
+        cell_grid &operator=(const cell_grid &) = delete;
+
+        std::size_t rows() const;
+        std::size_t cols() const;
+
+        // Blanks every cell.
+        cell_grid &resize(std::size_t rows, std::size_t cols);
+
+        // Pixel size of a cell, which should match the fixed font's
+        // advance and line height. The default, 7x14, fits the X11 fixed
+        // font.
+        cell_grid &set_cell_size(size s);
+        size cell_size() const;
+
+        cell_grid &set_origin(point p);
+        rect bounds() const;
+
+        const cell &at(std::size_t row, std::size_t col) const;
+
+        // Setting a cell to what it already holds damages nothing.
+        cell_grid &put(std::size_t row, std::size_t col, const cell &c);
+
+        // UTF-8 text from (row, col) on, cut at the end of the row.
+        cell_grid &write(std::size_t row, std::size_t col, const std::string &text, rgba fg, rgba bg);
+
+        cell_grid &clear();
+        cell_grid &clear(const cell &blank);
+
+        // Moves the rows up by n, or down when n is negative. The rows
+        // that come into view are set to blank.
+        cell_grid &scroll(int n);
+        cell_grid &scroll(int n, const cell &blank);
+
+    private:
+        std::size_t index(std::size_t row, std::size_t col) const;
+        rect cell_rect(std::size_t row, std::size_t col) const;
+        void set(std::size_t row, std::size_t col, const cell &c);
+        void mark(std::size_t i, const rect &r);
+        void mark_all();
+        void paint(gpx &g);
+
+        wnd &_w;
+        point _origin;
+        size _cell;
+        std::size_t _rows = 0;
+        std::size_t _cols = 0;
+        std::size_t _top = 0; // Ring slot of row 0
+
+        std::vector<cell> _cells;     // _rows ring slots of _cols cells
+        std::vector<uint64_t> _dirty; // One bit per cell, by ring slot
+        rect _requested;              // Damage asked for since the last paint
+
+        int _paint_slot = 0;
+    };
+
     // --- Layout manager. -------------------------------------------
     class layout_manager
     {
@@ -699,6 +1791,10 @@ namespace native
 
         // Access child list (optional)
         virtual const std::vector<wnd *> &children() const = 0;
+
+        // Natural size of the laid-out content, from the children's
+        // desired sizes. The default is the parent's dimensions.
+        virtual size measure(const wnd *parent) const;
     };
 
     class absolute_layout_manager final : public layout_manager
@@ -717,6 +1813,9 @@ namespace native
         void remove_child(wnd *child) override;
         const std::vector<wnd *> &children() const override;
 
+        // Extent of the children's current bounds.
+        size measure(const wnd *parent) const override;
+
     private:
         std::vector<wnd *> _children;
     };
@@ -728,7 +1827,8 @@ namespace native
         enum class unit
         {
             pixel,
-            star
+            star,
+            automatic // Sized to the largest desired size of its cells
         };
 
         float value = 1.0f;
@@ -736,10 +1836,12 @@ namespace native
 
         static grid_length pixels(float px);
         static grid_length star(float weight = 1.0f);
+        static grid_length auto_();
     };
 
     inline grid_length pixels(float px) { return grid_length::pixels(px); }
     inline grid_length star(float weight = 1.0f) { return grid_length::star(weight); }
+    inline grid_length auto_() { return grid_length::auto_(); }
 
     struct grid_row_def
     {
@@ -804,6 +1906,7 @@ namespace native
     public:
         grid_layout_manager();
         grid_layout_manager(int rows, int columns);
+        ~grid_layout_manager() override;
 
         // Classic API
         grid_layout_manager &add_row(grid_length length);
@@ -831,8 +1934,15 @@ namespace native
         void relayout(wnd *parent, const rect &bounds) override;
         void add_child(wnd *child) override;
         void remove_child(wnd *child) override;
+
+        // Removing a child moves the last one into its place, so the
+        // order changes.
         const std::vector<wnd *> &children() const override;
 
+        // Pixel tracks at their size; auto and star tracks at the largest
+        // desired size of the single-span cells in them.
+        size measure(const wnd *parent) const override;
+
     private:
         struct placed_child
         {
@@ -856,11 +1966,378 @@ namespace native
 
         std::vector<grid_length> _rows;
         std::vector<grid_length> _columns;
+        // Index of each child in _children and _placed_children, which
+        // run in parallel. Defined in layout.cpp to keep the hash map out
+        // of this header.
+        struct child_index;
+
         std::vector<wnd *> _children;
         std::vector<placed_child> _placed_children;
+        std::unique_ptr<child_index> _index;
         std::vector<nested_grid> _nested_grids;
+        std::vector<int> _row_edges;
+        std::vector<int> _column_edges;
+        std::vector<int> _row_content;
+        std::vector<int> _column_content;
         int _next_auto_row = 0;
         int _next_auto_column = 0;
+
+        void measure_tracks(const wnd *parent, std::vector<int> &rows, std::vector<int> &columns) const;
+    };
+
+    // Children one after another, each at its desired size along the
+    // stacking direction and stretched across it.
+    class stack_layout_manager final : public layout_manager
+    {
+    public:
+        enum class orientation
+        {
+            vertical,
+            horizontal
+        };
+
+        explicit stack_layout_manager(orientation o = orientation::vertical, int spacing = 0);
+
+        // DSL: stack << child_a << child_b;
+        stack_layout_manager &operator<<(wnd &child);
+
+        // Classic API
+        stack_layout_manager &add(wnd &child);
+
+        void relayout(wnd *parent, const rect &bounds) override;
+        void add_child(wnd *child) override;
+        void remove_child(wnd *child) override;
+        const std::vector<wnd *> &children() const override;
+        size measure(const wnd *parent) const override;
+
+    private:
+        orientation _orientation;
+        int _spacing;
+        std::vector<wnd *> _children;
+    };
+
+    enum class dock_side
+    {
+        left,
+        top,
+        right,
+        bottom,
+        fill
+    };
+
+    // Children docked to the edges of what the earlier children left
+    // over, in the order they were added. An edge child gets its desired
+    // width or height; a fill child takes the whole remaining area.
+    class dock_layout_manager final : public layout_manager
+    {
+    public:
+        dock_layout_manager() = default;
+
+        // Classic API. Children that only arrive through set_parent()
+        // fill.
+        dock_layout_manager &add(wnd &child, dock_side side);
+
+        void relayout(wnd *parent, const rect &bounds) override;
+        void add_child(wnd *child) override;
+        void remove_child(wnd *child) override;
+        const std::vector<wnd *> &children() const override;
+        size measure(const wnd *parent) const override;
+
+    private:
+        std::vector<wnd *> _children;
+        std::vector<dock_side> _sides;
+    };
+
+    // Grid with a fixed number of tracks. Track definitions are integer
+    // tables in std::array (star weights in 1/256ths), so relayout is
+    // loops of known length over stack arrays with no allocation and no
+    // floating point. Otherwise it is used like grid_layout_manager:
+    //
+    //   static_grid<2, 2> grid{{pixels(24), star()}, {star(), star(2)}};
+    //   grid << cell(toolbar, 0, 0, 1, 2) << cell(view, 1, 0);
+    //
+    // row() and column() entries define the tracks in order. Cells past
+    // the last track are clamped to it; nested grids are not supported.
+    // Placed cells are kept in a std::array of Rows * Cols entries, so a
+    // grid holds at most that many children and further adds are
+    // ignored. children() is the one std::vector the layout_manager
+    // interface needs; it is reserved up front and never grows past it.
+    template <std::size_t Rows, std::size_t Cols>
+    class static_grid final : public layout_manager
+    {
+        static_assert(Rows > 0 && Cols > 0, "static_grid needs at least one row and one column");
+
+    public:
+        struct track
+        {
+            grid_length::unit type = grid_length::unit::star;
+            int amount = 256; // Pixels, or the star weight in 1/256ths
+        };
+
+        static constexpr track make_track(const grid_length &l)
+        {
+            const float v = l.value > 0.0f ? l.value : 0.0f;
+            const int scale = l.type == grid_length::unit::star ? 256 : 1;
+            return track{l.type, static_cast<int>(v * scale + 0.5f)};
+        }
+
+        static_grid()
+        {
+            _children.reserve(Rows * Cols);
+        }
+
+        static_grid(const std::array<grid_length, Rows> &rows,
+                    const std::array<grid_length, Cols> &columns)
+            : static_grid()
+        {
+            for (std::size_t i = 0; i < Rows; ++i)
+                _rows[i] = make_track(rows[i]);
+            for (std::size_t i = 0; i < Cols; ++i)
+                _columns[i] = make_track(columns[i]);
+            _next_row = Rows;
+            _next_column = Cols;
+        }
+
+        // DSL: grid << row(star()) << column(pixels(80)) << cell(btn, 0, 0);
+        static_grid &operator<<(const grid_row_def &r)
+        {
+            if (_next_row < Rows)
+                _rows[_next_row++] = make_track(r.length);
+            return *this;
+        }
+
+        static_grid &operator<<(const grid_column_def &c)
+        {
+            if (_next_column < Cols)
+                _columns[_next_column++] = make_track(c.length);
+            return *this;
+        }
+
+        static_grid &operator<<(const grid_cell_def &p)
+        {
+            if (!p.child)
+                return *this;
+            return add(*p.child, p.row, p.column, p.row_span, p.column_span, p.margin);
+        }
+
+        static_grid &add(wnd &child,
+                         int row,
+                         int column,
+                         int row_span = 1,
+                         int column_span = 1,
+                         int margin = 0)
+        {
+            const int r = clamp(row, 0, static_cast<int>(Rows) - 1);
+            const int c = clamp(column, 0, static_cast<int>(Cols) - 1);
+            const placed p{&child,
+                           static_cast<uint16_t>(r),
+                           static_cast<uint16_t>(c),
+                           static_cast<uint16_t>(clamp(r + row_span, r + 1, static_cast<int>(Rows))),
+                           static_cast<uint16_t>(clamp(c + column_span, c + 1, static_cast<int>(Cols))),
+                           static_cast<uint16_t>(clamp(margin, 0, 0xffff))};
+
+            for (std::size_t i = 0; i < _count; ++i)
+            {
+                if (_cells[i].child == &child)
+                {
+                    _cells[i] = p;
+                    return *this;
+                }
+            }
+            if (_count == _cells.size())
+                return *this;
+
+            _cells[_count++] = p;
+            _children.push_back(&child);
+            return *this;
+        }
+
+        void relayout(wnd *parent, const rect &bounds) override
+        {
+            if (!parent)
+                return;
+
+            std::array<int, Rows + 1> ry{};
+            std::array<int, Cols + 1> cx{};
+            std::array<int, Rows> row_content{};
+            std::array<int, Cols> column_content{};
+            if (has_auto())
+                measure_tracks(row_content, column_content);
+
+            edges(_rows, row_content, bounds.d.h, bounds.p.y, ry);
+            edges(_columns, column_content, bounds.d.w, bounds.p.x, cx);
+
+            for (std::size_t i = 0; i < _count; ++i)
+            {
+                const placed &p = _cells[i];
+                const int x = cx[p.c] + p.margin;
+                const int y = ry[p.r] + p.margin;
+                const int w = cx[p.c2] - cx[p.c] - p.margin * 2;
+                const int h = ry[p.r2] - ry[p.r] - p.margin * 2;
+                const rect b(static_cast<coord>(clamp(x, -32768, 32767)),
+                             static_cast<coord>(clamp(y, -32768, 32767)),
+                             static_cast<dim>(clamp(w, 0, 65535)),
+                             static_cast<dim>(clamp(h, 0, 65535)));
+
+                const rect old = p.child->bounds();
+                if (old.p.x != b.p.x || old.p.y != b.p.y || old.d.w != b.d.w || old.d.h != b.d.h)
+                    p.child->set_bounds(b);
+            }
+        }
+
+        void add_child(wnd *child) override
+        {
+            if (!child || std::find(_children.begin(), _children.end(), child) != _children.end())
+                return;
+
+            const int n = static_cast<int>(_count);
+            add(*child, n / static_cast<int>(Cols), n % static_cast<int>(Cols));
+        }
+
+        void remove_child(wnd *child) override
+        {
+            // The last cell fills the hole; _children follows _cells.
+            for (std::size_t i = 0; i < _count; ++i)
+            {
+                if (_cells[i].child != child)
+                    continue;
+
+                _cells[i] = _cells[--_count];
+                _children[i] = _children.back();
+                _children.pop_back();
+                return;
+            }
+        }
+
+        const std::vector<wnd *> &children() const override
+        {
+            return _children;
+        }
+
+        size measure(const wnd *) const override
+        {
+            std::array<int, Rows> row_content{};
+            std::array<int, Cols> column_content{};
+            measure_tracks(row_content, column_content);
+
+            int w = 0;
+            int h = 0;
+            for (std::size_t i = 0; i < Cols; ++i)
+                w += _columns[i].type == grid_length::unit::pixel ? _columns[i].amount : column_content[i];
+            for (std::size_t i = 0; i < Rows; ++i)
+                h += _rows[i].type == grid_length::unit::pixel ? _rows[i].amount : row_content[i];
+            return size(static_cast<dim>(clamp(w, 0, 65535)), static_cast<dim>(clamp(h, 0, 65535)));
+        }
+
+    private:
+        // Track range [r, r2) x [c, c2), already clamped to the grid.
+        struct placed
+        {
+            wnd *child = nullptr;
+            uint16_t r, c, r2, c2;
+            uint16_t margin;
+        };
+
+        static constexpr int clamp(int v, int lo, int hi)
+        {
+            return v < lo ? lo : (v > hi ? hi : v);
+        }
+
+        bool has_auto() const
+        {
+            for (const auto &t : _rows)
+            {
+                if (t.type == grid_length::unit::automatic)
+                    return true;
+            }
+            for (const auto &t : _columns)
+            {
+                if (t.type == grid_length::unit::automatic)
+                    return true;
+            }
+            return false;
+        }
+
+        void measure_tracks(std::array<int, Rows> &rows, std::array<int, Cols> &columns) const
+        {
+            for (std::size_t i = 0; i < _count; ++i)
+            {
+                const placed &p = _cells[i];
+                const size d = p.child->desired_size();
+                if (p.r2 == p.r + 1)
+                    rows[p.r] = std::max(rows[p.r], d.h + p.margin * 2);
+                if (p.c2 == p.c + 1)
+                    columns[p.c] = std::max(columns[p.c], d.w + p.margin * 2);
+            }
+        }
+
+        // Same distribution as grid_layout_manager: fixed and auto tracks
+        // first, the rest split by weight, rounding leftovers one pixel
+        // at a time to the star tracks in order, or all to the last track
+        // when there are no weighted stars.
+        template <std::size_t N>
+        static void edges(const std::array<track, N> &defs,
+                          const std::array<int, N> &content,
+                          int total,
+                          int origin,
+                          std::array<int, N + 1> &out)
+        {
+            std::array<int, N> sz{};
+            int fixed = 0;
+            int weights = 0;
+            int stars = 0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (defs[i].type == grid_length::unit::star)
+                {
+                    weights += defs[i].amount;
+                    ++stars;
+                    continue;
+                }
+                sz[i] = defs[i].type == grid_length::unit::pixel ? defs[i].amount : content[i];
+                fixed += sz[i];
+            }
+
+            const int remaining = total > fixed ? total - fixed : 0;
+            if (weights > 0)
+            {
+                int used = 0;
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    if (defs[i].type != grid_length::unit::star)
+                        continue;
+                    sz[i] = static_cast<int>((static_cast<int64_t>(remaining) * defs[i].amount) / weights);
+                    used += sz[i];
+                }
+
+                for (int left = remaining - used; left > 0 && stars > 0;)
+                {
+                    for (std::size_t i = 0; i < N && left > 0; ++i)
+                    {
+                        if (defs[i].type != grid_length::unit::star)
+                            continue;
+                        ++sz[i];
+                        --left;
+                    }
+                }
+            }
+            else
+            {
+                sz[N - 1] += remaining;
+            }
+
+            out[0] = origin;
+            for (std::size_t i = 0; i < N; ++i)
+                out[i + 1] = out[i] + sz[i];
+        }
+
+        std::array<track, Rows> _rows{};
+        std::array<track, Cols> _columns{};
+        std::size_t _next_row = 0;
+        std::size_t _next_column = 0;
+        std::array<placed, Rows * Cols> _cells{};
+        std::size_t _count = 0;
+        std::vector<wnd *> _children; // _children[i] == _cells[i].child
     };
 
 }
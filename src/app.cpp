@@ -1,5 +1,7 @@
 #include <native.h>
 
+#include "layout_queue.h"
+
 namespace native
 {
     int app::run(const app_wnd &wnd)
@@ -24,4 +26,24 @@ namespace native
     {
         return _main_wnd;
     }
-}
\ No newline at end of file
+
+    void app::set_frame_rate(int fps)
+    {
+        _frame_rate = fps < 0 ? 0 : fps;
+    }
+
+    int app::frame_rate()
+    {
+        return _frame_rate;
+    }
+
+    void app::begin_update()
+    {
+        detail::layouts().begin();
+    }
+
+    void app::end_update()
+    {
+        detail::layouts().end();
+    }
+}
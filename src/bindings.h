@@ -1,9 +1,153 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
 
 namespace native
 {
+namespace detail
+{
+    // Open-addressing hash map for small trivially copyable keys such as
+    // native handles and pointers. Linear probing over a power-of-two
+    // table kept at most half full; erase shifts the following run back
+    // instead of leaving tombstones, so lookups never slow down with
+    // churn.
+    template <typename K, typename V>
+    class flat_map
+    {
+    public:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        // Slot index of key, or npos.
+        std::size_t find(const K &key) const
+        {
+            if (_count == 0)
+                return npos;
+
+            for (std::size_t i = home(key);; i = next(i))
+            {
+                const slot &s = _slots[i];
+                if (!s.used)
+                    return npos;
+                if (s.key == key)
+                    return i;
+            }
+        }
+
+        // Tries slot hint first; refreshes hint on a miss.
+        std::size_t find(const K &key, std::size_t &hint) const
+        {
+            if (hint < _slots.size() && _slots[hint].used && _slots[hint].key == key)
+                return hint;
+
+            hint = find(key);
+            return hint;
+        }
+
+        const V &value(std::size_t i) const { return _slots[i].value; }
+        V &value(std::size_t i) { return _slots[i].value; }
+
+        void insert(const K &key, const V &value)
+        {
+            if ((_count + 1) * 2 > _slots.size())
+                grow();
+
+            for (std::size_t i = home(key);; i = next(i))
+            {
+                slot &s = _slots[i];
+                if (!s.used)
+                {
+                    s.used = true;
+                    s.key = key;
+                    s.value = value;
+                    ++_count;
+                    return;
+                }
+                if (s.key == key)
+                {
+                    s.value = value;
+                    return;
+                }
+            }
+        }
+
+        void erase_at(std::size_t i)
+        {
+            // Backward-shift deletion: pull later members of the probe
+            // run into the hole until the run ends or an entry already
+            // sits at or after its home slot relative to the hole.
+            std::size_t hole = i;
+            for (std::size_t j = next(hole);; j = next(j))
+            {
+                slot &s = _slots[j];
+                if (!s.used)
+                    break;
+
+                const std::size_t h = home(s.key);
+                const bool movable = hole <= j ? (h <= hole || h > j) : (h <= hole && h > j);
+                if (movable)
+                {
+                    _slots[hole] = s;
+                    hole = j;
+                }
+            }
+
+            _slots[hole] = slot{};
+            --_count;
+        }
+
+        bool erase(const K &key)
+        {
+            const std::size_t i = find(key);
+            if (i == npos)
+                return false;
+            erase_at(i);
+            return true;
+        }
+
+        void clear()
+        {
+            _slots.clear();
+            _count = 0;
+        }
+
+    private:
+        struct slot
+        {
+            K key{};
+            V value{};
+            bool used = false;
+        };
+
+        std::size_t home(const K &key) const
+        {
+            // Fibonacci hashing spreads aligned pointers and sequential
+            // ids over the whole table.
+            const uint64_t h = static_cast<uint64_t>(std::hash<K>{}(key)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<std::size_t>(h >> 32) & (_slots.size() - 1);
+        }
+
+        std::size_t next(std::size_t i) const { return (i + 1) & (_slots.size() - 1); }
+
+        void grow()
+        {
+            std::vector<slot> old;
+            old.swap(_slots);
+            _slots.resize(old.empty() ? 16 : old.size() * 2);
+            _count = 0;
+            for (const slot &s : old)
+            {
+                if (s.used)
+                    insert(s.key, s.value);
+            }
+        }
+
+        std::vector<slot> _slots;
+        std::size_t _count = 0;
+    };
+}
 
     // A = handle type (e.g. Widget, HWND, Window)
     // B = associated object type (e.g. wnd*, control*, app_wnd*)
@@ -13,40 +157,55 @@ namespace native
     public:
         void register_pair(const A &a, const B &b)
         {
-            a_to_b_[a] = b;
-            b_to_a_[b] = a;
+            a_to_b_.insert(a, b);
+            b_to_a_.insert(b, a);
         }
 
         void unregister_by_a(const A &a)
         {
-            auto it = a_to_b_.find(a);
-            if (it != a_to_b_.end())
+            const std::size_t i = a_to_b_.find(a);
+            if (i != a_to_b_.npos)
             {
-                b_to_a_.erase(it->second);
-                a_to_b_.erase(it);
+                b_to_a_.erase(a_to_b_.value(i));
+                a_to_b_.erase_at(i);
             }
         }
 
         void unregister_by_b(const B &b)
         {
-            auto it = b_to_a_.find(b);
-            if (it != b_to_a_.end())
+            const std::size_t i = b_to_a_.find(b);
+            if (i != b_to_a_.npos)
             {
-                a_to_b_.erase(it->second);
-                b_to_a_.erase(it);
+                a_to_b_.erase(b_to_a_.value(i));
+                b_to_a_.erase_at(i);
             }
         }
 
         B from_a(const A &a) const
         {
-            auto it = a_to_b_.find(a);
-            return it != a_to_b_.end() ? it->second : B{};
+            const std::size_t i = a_to_b_.find(a);
+            return i != a_to_b_.npos ? a_to_b_.value(i) : B{};
         }
 
         A from_b(const B &b) const
         {
-            auto it = b_to_a_.find(b);
-            return it != b_to_a_.end() ? it->second : A{};
+            const std::size_t i = b_to_a_.find(b);
+            return i != b_to_a_.npos ? b_to_a_.value(i) : A{};
+        }
+
+        // Hinted lookups for hot paths. The caller keeps hint (initially
+        // 0) next to the key; while the pair stays put, the lookup is one
+        // slot compare instead of a hash probe.
+        B from_a(const A &a, std::size_t &hint) const
+        {
+            const std::size_t i = a_to_b_.find(a, hint);
+            return i != a_to_b_.npos ? a_to_b_.value(i) : B{};
+        }
+
+        A from_b(const B &b, std::size_t &hint) const
+        {
+            const std::size_t i = b_to_a_.find(b, hint);
+            return i != b_to_a_.npos ? b_to_a_.value(i) : A{};
         }
 
         void clear()
@@ -56,8 +215,8 @@ namespace native
         }
 
     private:
-        std::unordered_map<A, B> a_to_b_;
-        std::unordered_map<B, A> b_to_a_;
+        detail::flat_map<A, B> a_to_b_;
+        detail::flat_map<B, A> b_to_a_;
     };
 
 } // namespace native
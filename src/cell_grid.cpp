@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include <native.h>
+
+#include "control_paint_backend.h"
+#include "frame_scheduler.h"
+
+namespace native
+{
+    static void append_utf8(std::string &s, char32_t ch)
+    {
+        if (ch < 0x80)
+            s += static_cast<char>(ch);
+        else if (ch < 0x800)
+        {
+            s += static_cast<char>(0xc0 | (ch >> 6));
+            s += static_cast<char>(0x80 | (ch & 0x3f));
+        }
+        else if (ch < 0x10000)
+        {
+            s += static_cast<char>(0xe0 | (ch >> 12));
+            s += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+            s += static_cast<char>(0x80 | (ch & 0x3f));
+        }
+        else
+        {
+            s += static_cast<char>(0xf0 | (ch >> 18));
+            s += static_cast<char>(0x80 | ((ch >> 12) & 0x3f));
+            s += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+            s += static_cast<char>(0x80 | (ch & 0x3f));
+        }
+    }
+
+    // Decodes the code point at s[i] and advances i. Malformed bytes
+    // come out as U+FFFD, one per byte.
+    static char32_t next_utf8(const std::string &s, std::size_t &i)
+    {
+        const auto b = static_cast<unsigned char>(s[i++]);
+        if (b < 0x80)
+            return b;
+
+        const int extra = b >= 0xf0 ? 3 : b >= 0xe0 ? 2 : b >= 0xc0 ? 1 : -1;
+        if (extra < 0 || i + extra > s.size())
+            return U'\ufffd';
+
+        char32_t ch = b & (0x3f >> extra);
+        for (int k = 0; k < extra; ++k)
+        {
+            const auto c = static_cast<unsigned char>(s[i + k]);
+            if ((c & 0xc0) != 0x80)
+                return U'\ufffd';
+            ch = (ch << 6) | (c & 0x3f);
+        }
+        i += extra;
+        return ch;
+    }
+
+    static bool same(const cell_grid::cell &a, const cell_grid::cell &b)
+    {
+        return a.ch == b.ch && a.fg.value == b.fg.value && a.bg.value == b.bg.value;
+    }
+
+    static bool inside(const rect &r, const rect &outer)
+    {
+        return r.p.x >= outer.p.x && r.p.y >= outer.p.y &&
+               r.p.x + r.d.w <= outer.p.x + outer.d.w &&
+               r.p.y + r.d.h <= outer.p.y + outer.d.h;
+    }
+
+    cell_grid::cell_grid(wnd &w, point origin, std::size_t rows, std::size_t cols)
+        : _w(w),
+          _origin(origin),
+          _cell(7, 14)
+    {
+        resize(rows, cols);
+
+        // Runs after every handler connected later, so the cells land on
+        // top of them.
+        _paint_slot = _w.on_wnd_paint.connect([this](wnd_paint_event e) {
+            paint(e.g);
+            return false;
+        });
+    }
+
+    cell_grid::~cell_grid()
+    {
+        _w.on_wnd_paint.disconnect(_paint_slot);
+    }
+
+    std::size_t cell_grid::rows() const
+    {
+        return _rows;
+    }
+
+    std::size_t cell_grid::cols() const
+    {
+        return _cols;
+    }
+
+    cell_grid &cell_grid::resize(std::size_t rows, std::size_t cols)
+    {
+        _w.invalidate(bounds());
+        _rows = rows;
+        _cols = cols;
+        _top = 0;
+        _cells.assign(_rows * _cols, cell());
+        _dirty.assign((_cells.size() + 63) / 64, 0);
+        mark_all();
+        return *this;
+    }
+
+    cell_grid &cell_grid::set_cell_size(size s)
+    {
+        _w.invalidate(bounds());
+        _cell = s;
+        mark_all();
+        return *this;
+    }
+
+    size cell_grid::cell_size() const
+    {
+        return _cell;
+    }
+
+    cell_grid &cell_grid::set_origin(point p)
+    {
+        _w.invalidate(bounds());
+        _origin = p;
+        mark_all();
+        return *this;
+    }
+
+    rect cell_grid::bounds() const
+    {
+        return rect(_origin.x, _origin.y,
+                    static_cast<dim>(std::min<std::size_t>(0xffff, _cols * _cell.w)),
+                    static_cast<dim>(std::min<std::size_t>(0xffff, _rows * _cell.h)));
+    }
+
+    const cell_grid::cell &cell_grid::at(std::size_t row, std::size_t col) const
+    {
+        return _cells[index(row, col)];
+    }
+
+    cell_grid &cell_grid::put(std::size_t row, std::size_t col, const cell &c)
+    {
+        if (row < _rows && col < _cols)
+            set(row, col, c);
+        return *this;
+    }
+
+    cell_grid &cell_grid::write(std::size_t row, std::size_t col, const std::string &text, rgba fg, rgba bg)
+    {
+        if (row >= _rows)
+            return *this;
+
+        cell c;
+        c.fg = fg;
+        c.bg = bg;
+        for (std::size_t i = 0; i < text.size() && col < _cols; ++col)
+        {
+            c.ch = next_utf8(text, i);
+            set(row, col, c);
+        }
+        return *this;
+    }
+
+    cell_grid &cell_grid::clear()
+    {
+        return clear(cell());
+    }
+
+    cell_grid &cell_grid::clear(const cell &blank)
+    {
+        for (std::size_t r = 0; r < _rows; ++r)
+        {
+            for (std::size_t c = 0; c < _cols; ++c)
+                set(r, c, blank);
+        }
+        return *this;
+    }
+
+    cell_grid &cell_grid::scroll(int n)
+    {
+        return scroll(n, cell());
+    }
+
+    cell_grid &cell_grid::scroll(int n, const cell &blank)
+    {
+        if (n == 0 || _rows == 0)
+            return *this;
+
+        const std::size_t k = static_cast<std::size_t>(std::abs(n));
+        if (k >= _rows)
+            return clear(blank);
+
+        // Turning the ring moves every row at once. The cells keep their
+        // slots and dirty bits, so only the pixels have to move.
+        _top = n > 0 ? (_top + k) % _rows : (_top + _rows - k) % _rows;
+
+        const int dy = -n * static_cast<int>(_cell.h);
+        _w.scroll(bounds(), 0, static_cast<coord>(dy));
+
+        // Cells still waiting to be painted moved with the rows.
+        if (_requested.d.w > 0 && _requested.d.h > 0)
+        {
+            const rect moved(_requested.p.x, static_cast<coord>(_requested.p.y + dy),
+                             _requested.d.w, _requested.d.h);
+            _requested = moved.intersect(bounds());
+            if (_requested.d.w > 0 && _requested.d.h > 0)
+                _w.invalidate(_requested);
+        }
+
+        // The uncovered rows held the rows that scrolled out.
+        const std::size_t first = n > 0 ? _rows - k : 0;
+        for (std::size_t r = first; r < first + k; ++r)
+        {
+            for (std::size_t c = 0; c < _cols; ++c)
+            {
+                const std::size_t i = index(r, c);
+                _cells[i] = blank;
+                mark(i, cell_rect(r, c));
+            }
+        }
+        return *this;
+    }
+
+    std::size_t cell_grid::index(std::size_t row, std::size_t col) const
+    {
+        std::size_t slot = _top + row;
+        if (slot >= _rows)
+            slot -= _rows;
+        return slot * _cols + col;
+    }
+
+    rect cell_grid::cell_rect(std::size_t row, std::size_t col) const
+    {
+        return rect(static_cast<coord>(_origin.x + col * _cell.w),
+                    static_cast<coord>(_origin.y + row * _cell.h),
+                    _cell.w, _cell.h);
+    }
+
+    void cell_grid::set(std::size_t row, std::size_t col, const cell &c)
+    {
+        const std::size_t i = index(row, col);
+        if (same(_cells[i], c))
+            return;
+
+        _cells[i] = c;
+        mark(i, cell_rect(row, col));
+    }
+
+    void cell_grid::mark(std::size_t i, const rect &r)
+    {
+        _dirty[i >> 6] |= uint64_t(1) << (i & 63);
+
+        // Most updates land inside damage that is already pending.
+        if (inside(r, _requested))
+            return;
+        _requested = detail::unite(_requested, r);
+        _w.invalidate(r);
+    }
+
+    void cell_grid::mark_all()
+    {
+        std::fill(_dirty.begin(), _dirty.end(), ~uint64_t(0));
+        _requested = bounds();
+        _w.invalidate(_requested);
+    }
+
+    void cell_grid::paint(gpx &g)
+    {
+        const rect clip = g.clip();
+        const rect area = clip.intersect(bounds());
+        if (area.d.w == 0 || area.d.h == 0 || _cell.w == 0 || _cell.h == 0)
+            return;
+
+        // The backbuffer still holds the clean cells only when it is
+        // preserved and the damage is all the grid's own. Otherwise
+        // every cell in the area is drawn.
+        const bool all = !_w.preserve_contents() || !inside(clip, _requested);
+
+        const std::size_t c0 = static_cast<std::size_t>(area.p.x - _origin.x) / _cell.w;
+        const std::size_t c1 = std::min(_cols, static_cast<std::size_t>(area.p.x + area.d.w - _origin.x + _cell.w - 1) / _cell.w);
+        const std::size_t r0 = static_cast<std::size_t>(area.p.y - _origin.y) / _cell.h;
+        const std::size_t r1 = std::min(_rows, static_cast<std::size_t>(area.p.y + area.d.h - _origin.y + _cell.h - 1) / _cell.h);
+
+        // Cells cut by the clip are drawn in part and stay dirty.
+        const auto full_from = [](int from, int cell) { return static_cast<std::size_t>((from + cell - 1) / cell); };
+        const std::size_t fc0 = full_from(area.p.x - _origin.x, _cell.w);
+        const std::size_t fc1 = static_cast<std::size_t>(area.p.x + area.d.w - _origin.x) / _cell.w;
+        const std::size_t fr0 = full_from(area.p.y - _origin.y, _cell.h);
+        const std::size_t fr1 = static_cast<std::size_t>(area.p.y + area.d.h - _origin.y) / _cell.h;
+
+        const rgba ink = g.ink();
+        const font_t &font = g.font();
+        g.set_clip(area);
+        g.set_font(font_t::stock(font_role::fixed));
+
+        std::string text;
+        for (std::size_t r = r0; r < r1; ++r)
+        {
+            const std::size_t base = index(r, 0);
+            std::size_t c = c0;
+            while (c < c1)
+            {
+                std::size_t i = base + c;
+                if (!all)
+                {
+                    // Skip to the next dirty cell, a word at a time.
+                    uint64_t word = _dirty[i >> 6] & (~uint64_t(0) << (i & 63));
+                    while (!word && (i | 63) + 1 < base + c1)
+                    {
+                        i = (i | 63) + 1;
+                        word = _dirty[i >> 6];
+                    }
+                    if (!word)
+                        break;
+                    i = (i & ~std::size_t(63)) + static_cast<std::size_t>(__builtin_ctzll(word));
+                    if (i >= base + c1)
+                        break;
+                    c = i - base;
+                }
+
+                // A run is the dirty cells that follow with the same
+                // colours; in the all case, any cells that follow.
+                const cell &first = _cells[i];
+                std::size_t end = c + 1;
+                while (end < c1)
+                {
+                    const std::size_t j = base + end;
+                    const cell &next = _cells[j];
+                    if (next.fg.value != first.fg.value || next.bg.value != first.bg.value)
+                        break;
+                    if (!all && !(_dirty[j >> 6] & (uint64_t(1) << (j & 63))))
+                        break;
+                    ++end;
+                }
+
+                text.clear();
+                for (std::size_t k = c; k < end; ++k)
+                {
+                    const std::size_t j = base + k;
+                    append_utf8(text, _cells[j].ch);
+                    if (r >= fr0 && r < fr1 && k >= fc0 && k < fc1)
+                        _dirty[j >> 6] &= ~(uint64_t(1) << (j & 63));
+                }
+
+                const rect run(static_cast<coord>(_origin.x + c * _cell.w),
+                               static_cast<coord>(_origin.y + r * _cell.h),
+                               static_cast<dim>((end - c) * _cell.w), _cell.h);
+                g.set_ink(first.bg).draw_rect(run, true);
+                g.set_ink(first.fg).draw_text(text, point(run.p.x, detail::control_paint_backend_text_y_centered(run)));
+                c = end;
+            }
+        }
+
+        g.set_font(font).set_ink(ink);
+        g.set_clip(clip);
+
+        // A paint takes all of the window's damage. Cells that were not
+        // reached lie outside the window and stay dirty until an expose
+        // or resize damages them.
+        _requested = rect();
+    }
+}
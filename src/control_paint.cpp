@@ -1,4 +1,8 @@
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <native.h>
 
@@ -6,6 +10,110 @@
 
 namespace native
 {
+    static rgba button_bg(const control_paint::palette &p, const control_paint::state &s)
+    {
+        return s.pressed ? p.button_pressed_bg : (s.hot ? p.button_hot_bg : p.button_bg);
+    }
+
+    static rgba menu_item_bg(const control_paint::palette &p, const control_paint::state &s)
+    {
+        return s.selected || s.hot ? p.menu_hot_bg : p.menu_popup_bg;
+    }
+
+    enum class skin_kind
+    {
+        button,
+        menu_item
+    };
+
+    // Skins are drawn at one height per size class and stretched from
+    // there, so buttons of 22 and 26 pixels share one. Between the
+    // corners they are one pixel wide, which stretches as a fill.
+    static constexpr int skin_heights[] = {16, 28, 48};
+    static constexpr int skin_corner = 4;
+
+    struct skin_cache
+    {
+        std::mutex lock;
+        bool has_palette = false;
+        control_paint::palette palette;
+        std::unordered_map<uint32_t, std::shared_ptr<const img>> skins;
+    };
+
+    static std::atomic<bool> skins_on{false};
+
+    static skin_cache &skin_cache_instance()
+    {
+        static skin_cache cache;
+        return cache;
+    }
+
+    static uint32_t skin_key(skin_kind kind, int size_class, const control_paint::state &s)
+    {
+        return static_cast<uint32_t>(kind) << 8 | static_cast<uint32_t>(size_class) << 4 |
+               (s.hot ? 1u : 0u) | (s.pressed ? 2u : 0u) | (s.selected ? 4u : 0u) | (s.disabled ? 8u : 0u);
+    }
+
+    // The skin for kind in state s at the size class of height h, and the
+    // palette it was drawn with. Drawn on first use through a software
+    // painter, so no backend hook can take over.
+    static std::shared_ptr<const img> skin_for(skin_kind kind, const control_paint::state &s, dim h,
+                                               control_paint::palette &p)
+    {
+        const int size_class = h < 24 ? 0 : (h < 40 ? 1 : 2);
+        skin_cache &cache = skin_cache_instance();
+        std::lock_guard<std::mutex> guard(cache.lock);
+
+        if (!cache.has_palette)
+        {
+            cache.palette = control_paint::native_palette();
+            cache.has_palette = true;
+        }
+        p = cache.palette;
+
+        std::shared_ptr<const img> &skin = cache.skins[skin_key(kind, size_class, s)];
+        if (!skin)
+        {
+            const dim w = 2 * skin_corner + 1;
+            const dim h = static_cast<dim>(skin_heights[size_class]);
+            auto drawn = std::make_shared<img>(w, h);
+            std::unique_ptr<gpx> g = drawn->create_gpx();
+            const rect all(0, 0, w, h);
+            if (kind == skin_kind::button)
+            {
+                g->set_ink(button_bg(p, s)).draw_rect(all, true);
+                g->set_ink(p.button_border).draw_rect(all, false);
+            }
+            else
+                g->set_ink(menu_item_bg(p, s)).draw_rect(all, true);
+            skin = std::move(drawn);
+        }
+        return skin;
+    }
+
+    static void draw_skin(gpx &g, const img &skin, const rect &r)
+    {
+        g.draw_img_nine_slice(skin, rect(skin_corner, skin_corner, 1, static_cast<dim>(skin.h() - 2 * skin_corner)), r);
+    }
+
+    void control_paint::use_skins(bool on)
+    {
+        skins_on = on;
+    }
+
+    bool control_paint::skins()
+    {
+        return skins_on;
+    }
+
+    void control_paint::invalidate_skins()
+    {
+        skin_cache &cache = skin_cache_instance();
+        std::lock_guard<std::mutex> guard(cache.lock);
+        cache.has_palette = false;
+        cache.skins.clear();
+    }
+
     control_paint::control_paint(gpx &painter)
         : _g(painter)
     {
@@ -30,9 +138,8 @@ namespace native
         const rgba old_ink = _g.ink();
         const uint8_t old_pen = _g.pen();
 
-        const rgba bg = s.pressed ? p.button_pressed_bg : (s.hot ? p.button_hot_bg : p.button_bg);
         _g.set_pen(1);
-        _g.set_ink(bg).draw_rect(r, true);
+        _g.set_ink(button_bg(p, s)).draw_rect(r, true);
 
         _g.set_pen(old_pen).set_ink(old_ink);
         return *this;
@@ -58,8 +165,14 @@ namespace native
     {
         if (detail::control_paint_backend_draw_button_text_native(_g, r, text, s))
             return *this;
+        return draw_button_label(r, text, s, native_palette());
+    }
 
-        const palette p = native_palette();
+    control_paint &control_paint::draw_button_label(const rect &r,
+                                                    const std::string &text,
+                                                    const state &s,
+                                                    const palette &p)
+    {
         const rgba old_ink = _g.ink();
         const uint8_t old_pen = _g.pen();
         const font_t &old_font = _g.font();
@@ -83,6 +196,23 @@ namespace native
 
     control_paint &control_paint::draw_button(const rect &r, const std::string &text, const state &s)
     {
+        // A backend that paints the face natively is left to paint the
+        // rest too; otherwise face and frame come from one skin blit.
+        if (skins())
+        {
+            if (detail::control_paint_backend_draw_button_face_native(_g, r, s))
+            {
+                draw_button_frame(r, s);
+                return draw_button_text(r, text, s);
+            }
+
+            palette p;
+            draw_skin(_g, *skin_for(skin_kind::button, s, r.d.h, p), r);
+            if (detail::control_paint_backend_draw_button_text_native(_g, r, text, s))
+                return *this;
+            return draw_button_label(r, text, s, p);
+        }
+
         draw_button_face(r, s);
         draw_button_frame(r, s);
         draw_button_text(r, text, s);
@@ -110,13 +240,19 @@ namespace native
         if (detail::control_paint_backend_draw_menu_item_background_native(_g, r, s))
             return *this;
 
+        if (skins())
+        {
+            palette p;
+            draw_skin(_g, *skin_for(skin_kind::menu_item, s, r.d.h, p), r);
+            return *this;
+        }
+
         const palette p = native_palette();
         const rgba old_ink = _g.ink();
         const uint8_t old_pen = _g.pen();
-        const bool active = s.selected || s.hot;
 
         _g.set_pen(1);
-        _g.set_ink(active ? p.menu_hot_bg : p.menu_popup_bg).draw_rect(r, true);
+        _g.set_ink(menu_item_bg(p, s)).draw_rect(r, true);
 
         _g.set_pen(old_pen).set_ink(old_ink);
         return *this;
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <native.h>
+
+#include "frame_scheduler.h"
+
+namespace native
+{
+namespace detail
+{
+    frame_scheduler &frames()
+    {
+        static frame_scheduler instance;
+        return instance;
+    }
+
+    rect unite(const rect &a, const rect &b)
+    {
+        if (a.d.w == 0 || a.d.h == 0)
+            return b;
+        if (b.d.w == 0 || b.d.h == 0)
+            return a;
+
+        const int x1 = std::min<int>(a.p.x, b.p.x);
+        const int y1 = std::min<int>(a.p.y, b.p.y);
+        // Keep x2()/y2() representable as coord.
+        const int limit = std::numeric_limits<coord>::max();
+        const int x2 = std::min(limit, std::max<int>(a.p.x + a.d.w, b.p.x + b.d.w));
+        const int y2 = std::min(limit, std::max<int>(a.p.y + a.d.h, b.p.y + b.d.h));
+        return rect(static_cast<coord>(x1), static_cast<coord>(y1),
+                    static_cast<dim>(x2 - x1), static_cast<dim>(y2 - y1));
+    }
+
+    static rect whole_window()
+    {
+        const dim all = std::numeric_limits<coord>::max();
+        return rect(0, 0, all, all);
+    }
+
+    frame_scheduler::dirty_wnd &frame_scheduler::entry(const wnd *w)
+    {
+        for (auto &d : _dirty)
+        {
+            if (d.w == w)
+                return d;
+        }
+        _dirty.push_back({const_cast<wnd *>(w), rect(), rect()});
+        return _dirty.back();
+    }
+
+    void frame_scheduler::request(const wnd *w)
+    {
+        request(w, whole_window());
+    }
+
+    void frame_scheduler::request(const wnd *w, const rect &r)
+    {
+        if (!w)
+            return;
+
+        auto &d = entry(w);
+        d.damage = unite(d.damage, r);
+        d.exposed = unite(d.exposed, r);
+    }
+
+    void frame_scheduler::present(const wnd *w)
+    {
+        present(w, whole_window());
+    }
+
+    void frame_scheduler::present(const wnd *w, const rect &r)
+    {
+        if (!w)
+            return;
+
+        auto &d = entry(w);
+        d.exposed = unite(d.exposed, r);
+    }
+
+    void frame_scheduler::cancel(const wnd *w)
+    {
+        _dirty.erase(std::remove_if(_dirty.begin(), _dirty.end(),
+                                    [w](const dirty_wnd &d) { return d.w == w; }),
+                     _dirty.end());
+        for (auto &d : _painting)
+        {
+            if (d.w == w)
+                d.w = nullptr;
+        }
+    }
+
+    void frame_scheduler::scroll(const wnd *w, const rect &r, int dx, int dy)
+    {
+        for (auto &d : _dirty)
+        {
+            if (d.w != w)
+                continue;
+
+            const rect inside = d.damage.intersect(r);
+            if (inside.d.w == 0 || inside.d.h == 0)
+                return;
+
+            // In int: the moved box may leave the range of coord before
+            // it is clipped to r.
+            const int x1 = std::max<int>(inside.p.x + dx, r.p.x);
+            const int y1 = std::max<int>(inside.p.y + dy, r.p.y);
+            const int x2 = std::min<int>(inside.p.x + inside.d.w + dx, r.p.x + r.d.w);
+            const int y2 = std::min<int>(inside.p.y + inside.d.h + dy, r.p.y + r.d.h);
+            if (x1 >= x2 || y1 >= y2)
+                return;
+
+            const rect moved(static_cast<coord>(x1), static_cast<coord>(y1),
+                             static_cast<dim>(x2 - x1), static_cast<dim>(y2 - y1));
+            d.damage = unite(d.damage, moved);
+            d.exposed = unite(d.exposed, moved);
+            return;
+        }
+    }
+
+    uint64_t deferred::now_ms()
+    {
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+        return static_cast<uint64_t>(ms.count());
+    }
+
+    deferred::deferred()
+    {
+        frames().add(this);
+    }
+
+    deferred::~deferred()
+    {
+        frames().remove(this);
+    }
+
+    void frame_scheduler::add(deferred *d)
+    {
+        _deferred.push_back(d);
+    }
+
+    void frame_scheduler::remove(deferred *d)
+    {
+        // Only cleared here; run() may be walking the list.
+        for (auto &p : _deferred)
+        {
+            if (p == d)
+            {
+                p = nullptr;
+                _deferred_removed = true;
+                return;
+            }
+        }
+    }
+
+    void frame_scheduler::deliver_due()
+    {
+        if (_deferred_removed)
+        {
+            _deferred.erase(std::remove(_deferred.begin(), _deferred.end(), nullptr),
+                            _deferred.end());
+            _deferred_removed = false;
+        }
+
+        // Indexed, because a handler may create or destroy adapters.
+        const uint64_t now = deferred::now_ms();
+        for (std::size_t i = 0; i < _deferred.size(); ++i)
+        {
+            deferred *d = _deferred[i];
+            if (d && d->pending() && d->due() <= now)
+                d->fire(now);
+        }
+    }
+
+    bool frame_scheduler::scheduled() const
+    {
+        return !_dirty.empty() || !app::on_frame.empty();
+    }
+
+    int frame_scheduler::wait_ms() const
+    {
+        int wait = scheduled() ? frame_wait_ms() : -1;
+
+        const uint64_t now = deferred::now_ms();
+        for (const deferred *d : _deferred)
+        {
+            if (!d || !d->pending())
+                continue;
+
+            const int due = d->due() <= now ? 0 : static_cast<int>(std::min<uint64_t>(d->due() - now, INT32_MAX));
+            wait = wait < 0 ? due : std::min(wait, due);
+        }
+        return wait;
+    }
+
+    int frame_scheduler::frame_wait_ms() const
+    {
+        const int fps = app::frame_rate();
+        if (fps <= 0)
+            return 0;
+
+        const auto interval = std::chrono::microseconds(1000000 / fps);
+        const auto elapsed = clock::now() - _last_tick;
+        if (elapsed >= interval)
+            return 0;
+
+        // Round up so the loop does not wake a fraction of a ms early.
+        const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(interval - elapsed);
+        return static_cast<int>((remaining.count() + 999) / 1000);
+    }
+
+    void frame_scheduler::run(paint_fn paint)
+    {
+        deliver_due();
+
+        if (!scheduled() || frame_wait_ms() > 0)
+            return;
+
+        const auto now = clock::now();
+        _last_tick = now;
+
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
+        app::on_frame.emit(static_cast<uint64_t>(ms.count()));
+
+        // Swap out the dirty list so invalidate() during paint lands in
+        // the next tick instead of extending this one.
+        _painting.swap(_dirty);
+        for (const auto &d : _painting)
+        {
+            if (d.w)
+                paint(d.w, d.damage, d.exposed);
+        }
+        _painting.clear();
+    }
+}
+}
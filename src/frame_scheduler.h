@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include <native.h>
+
+namespace native
+{
+namespace detail
+{
+    // Per-app frame scheduler used by the event-loop backends.
+    // wnd::invalidate() only marks a window dirty. Once its event queue is
+    // drained, the backend loop calls run(), which paints every dirty
+    // window at most once per tick, paced by app::frame_rate().
+    class frame_scheduler
+    {
+    public:
+        // damage needs painting; exposed needs presenting and always
+        // covers damage. Both are in window coordinates and may extend
+        // past the window.
+        using paint_fn = void (*)(wnd *w, const rect &damage, const rect &exposed);
+
+        // Damages the whole window.
+        void request(const wnd *w);
+
+        // Adds r to the window's damage.
+        void request(const wnd *w, const rect &r);
+
+        // Presents r without painting, for pixels that are already in the
+        // backbuffer (retained contents, scrolled areas, overlays).
+        void present(const wnd *w);
+        void present(const wnd *w, const rect &r);
+
+        void cancel(const wnd *w);
+
+        // Moves the pending damage inside r by (dx, dy), clipped to r, for
+        // a scroll that has just copied r's pixels. The old place stays
+        // damaged as well, since one box cannot hold both.
+        void scroll(const wnd *w, const rect &r, int dx, int dy);
+
+        // Signal adapters register for their lifetime. Due adapters are
+        // delivered at the start of every run(), independent of frame
+        // pacing.
+        void add(deferred *d);
+        void remove(deferred *d);
+
+        // Milliseconds the loop may block before the next tick is due,
+        // or -1 when nothing is scheduled and it may block indefinitely.
+        int wait_ms() const;
+
+        // Delivers due signal adapters. Then, if a tick is due, emits
+        // app::on_frame and paints each window that was dirty. Windows
+        // invalidated while painting are deferred to the next tick.
+        void run(paint_fn paint);
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct dirty_wnd
+        {
+            wnd *w;
+            rect damage;
+            rect exposed;
+        };
+
+        dirty_wnd &entry(const wnd *w);
+        bool scheduled() const;
+        int frame_wait_ms() const;
+        void deliver_due();
+
+        std::vector<dirty_wnd> _dirty;
+        std::vector<dirty_wnd> _painting;
+        clock::time_point _last_tick;
+
+        std::vector<deferred *> _deferred; // nullptr once removed
+        bool _deferred_removed = false;
+    };
+
+    frame_scheduler &frames();
+
+    // Bounding box of two damage rects; an empty rect adds nothing.
+    rect unite(const rect &a, const rect &b);
+}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace native
+{
+namespace detail
+{
+    // Built-in 5x7 bitmap font shared by software text paths.
+    // Each row stores glyph_w bits, most significant bit on the left.
+    constexpr int glyph_w = 5;
+    constexpr int glyph_h = 7;
+    constexpr int glyph_advance = glyph_w + 1;
+
+    // Fills rows for ch and returns true, or returns false for unknown
+    // characters (rows are zeroed). Lowercase maps to uppercase.
+    bool glyph_rows(char ch, uint8_t rows[glyph_h]);
+
+    int glyph_text_width(const std::string &text);
+}
+}
@@ -36,6 +36,17 @@ namespace native
         return _thickness;
     }
 
+    gpx &gpx::set_cap(line_cap c)
+    {
+        _cap = c;
+        return *this;
+    }
+
+    line_cap gpx::cap() const
+    {
+        return _cap;
+    }
+
     gpx &gpx::set_font(const font_t &f)
     {
         _font = &f;
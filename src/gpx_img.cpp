@@ -0,0 +1,971 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <native.h>
+#include "gpx_img.h"
+#include "glyphs.h"
+#include "gradient_map.h"
+#include "img_text_backend.h"
+#include "nine_slice.h"
+#include "scroll.h"
+
+namespace native
+{
+
+    gpx_img::gpx_img(const img &image)
+        : _img(image), _clip(0, 0, image.w(), image.h())
+    {
+    }
+
+    gpx &gpx_img::set_clip(const rect &r)
+    {
+        _clip = r;
+        return *this;
+    }
+
+    rect gpx_img::clip() const
+    {
+        return _clip;
+    }
+
+    void gpx_img::clip_bounds(int &x1, int &y1, int &x2, int &y2) const
+    {
+        x1 = std::max(0, static_cast<int>(_clip.p.x));
+        y1 = std::max(0, static_cast<int>(_clip.p.y));
+        x2 = std::min(static_cast<int>(_img.w()), static_cast<int>(_clip.p.x) + static_cast<int>(_clip.d.w));
+        y2 = std::min(static_cast<int>(_img.h()), static_cast<int>(_clip.p.y) + static_cast<int>(_clip.d.h));
+    }
+
+    void gpx_img::fill_span(int x1, int x2, int y, rgba color)
+    {
+        rgba *row = const_cast<rgba *>(_img.pixels()) + y * _img.w();
+        std::fill(row + x1, row + x2, color);
+    }
+
+    gpx &gpx_img::clear(rgba color)
+    {
+        int x1, y1, x2, y2;
+        clip_bounds(x1, y1, x2, y2);
+        if (x1 >= x2)
+            return *this;
+
+        for (int y = y1; y < y2; ++y)
+            fill_span(x1, x2, y, color);
+        return *this;
+    }
+
+    gpx &gpx_img::draw_line(point from, point to)
+    {
+        int x1, y1, x2, y2;
+        clip_bounds(x1, y1, x2, y2);
+        if (x1 >= x2 || y1 >= y2)
+            return *this;
+
+        if (_thickness > 1)
+            wide_line(from, to, x1, y1, x2, y2);
+        else
+            hairline(from, to, x1, y1, x2, y2);
+        return *this;
+    }
+
+    void gpx_img::hairline(point from, point to, int x1, int y1, int x2, int y2)
+    {
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        const int stride = _img.w();
+
+        // Rows and columns need no stepping.
+        if (from.y == to.y)
+        {
+            const int a = std::max(x1, static_cast<int>(std::min(from.x, to.x)));
+            const int b = std::min(x2, static_cast<int>(std::max(from.x, to.x)) + 1);
+            if (from.y >= y1 && from.y < y2 && a < b)
+                fill_span(a, b, from.y, _ink);
+            return;
+        }
+        if (from.x == to.x)
+        {
+            const int a = std::max(y1, static_cast<int>(std::min(from.y, to.y)));
+            const int b = std::min(y2, static_cast<int>(std::max(from.y, to.y)) + 1);
+            if (from.x >= x1 && from.x < x2)
+            {
+                for (int y = a; y < b; ++y)
+                    pixels[y * stride + from.x] = _ink;
+            }
+            return;
+        }
+
+        // Liang-Barsky against the box of the clip's pixel centres, half
+        // a pixel wider: every pixel of the line that is inside the clip
+        // lies on the part of the segment that is left.
+        const int dx = to.x - from.x;
+        const int dy = to.y - from.y;
+        double t0 = 0, t1 = 1;
+        const auto clip_t = [&](double p, double q) {
+            if (p == 0)
+                return q >= 0;
+            const double t = q / p;
+            if (p < 0)
+            {
+                if (t > t1)
+                    return false;
+                t0 = std::max(t0, t);
+            }
+            else
+            {
+                if (t < t0)
+                    return false;
+                t1 = std::min(t1, t);
+            }
+            return true;
+        };
+        if (!clip_t(-dx, from.x - (x1 - 0.5)) || !clip_t(dx, (x2 - 0.5) - from.x) ||
+            !clip_t(-dy, from.y - (y1 - 0.5)) || !clip_t(dy, (y2 - 0.5) - from.y))
+            return;
+
+        // Step k of n along the major axis lands round(k * m / n) along
+        // the minor one, as Bresenham steps it; so the walk can start at
+        // any k.
+        const bool x_major = std::abs(dx) >= std::abs(dy);
+        const int n = x_major ? std::abs(dx) : std::abs(dy);
+        const int m = x_major ? std::abs(dy) : std::abs(dx);
+        const int sx = dx < 0 ? -1 : 1;
+        const int sy = dy < 0 ? -1 : 1;
+        const auto at = [&](int k, int &x, int &y) {
+            const int minor = static_cast<int>((2LL * k * m + n) / (2LL * n));
+            x = from.x + sx * (x_major ? k : minor);
+            y = from.y + sy * (x_major ? minor : k);
+        };
+        const auto inside = [&](int k) {
+            int x, y;
+            at(k, x, y);
+            return x >= x1 && x < x2 && y >= y1 && y < y2;
+        };
+
+        // Rounding moves the ends by at most one step.
+        int k0 = std::max(0, static_cast<int>(std::floor(t0 * n)) - 1);
+        int k1 = std::min(n, static_cast<int>(std::ceil(t1 * n)) + 1);
+        while (k0 <= k1 && !inside(k0))
+            ++k0;
+        while (k1 >= k0 && !inside(k1))
+            --k1;
+        if (k0 > k1)
+            return;
+
+        int x, y;
+        at(k0, x, y);
+        rgba *p = pixels + y * stride + x;
+        const int major_step = x_major ? sx : sy * stride;
+        const int minor_step = x_major ? sy * stride : sx;
+        long long err = (2LL * k0 * m + n) % (2LL * n);
+
+        for (int k = k0;;)
+        {
+            *p = _ink;
+            if (++k > k1)
+                break;
+            p += major_step;
+            err += 2LL * m;
+            if (err >= 2LL * n)
+            {
+                err -= 2LL * n;
+                p += minor_step;
+            }
+        }
+    }
+
+    void gpx_img::wide_line(point from, point to, int x1, int y1, int x2, int y2)
+    {
+        // The line runs between pixel centres. Its outline is convex, so
+        // each row is one span: the pixels whose centres it covers.
+        const float half = _thickness * 0.5f;
+        float ax = from.x + 0.5f, ay = from.y + 0.5f;
+        float bx = to.x + 0.5f, by = to.y + 0.5f;
+        const float len = std::hypot(bx - ax, by - ay);
+        if (len == 0 && _cap == line_cap::butt)
+            return;
+
+        const float ux = len > 0 ? (bx - ax) / len : 1;
+        const float uy = len > 0 ? (by - ay) / len : 0;
+        if (_cap == line_cap::square)
+        {
+            ax -= ux * half;
+            ay -= uy * half;
+            bx += ux * half;
+            by += uy * half;
+        }
+
+        const float nx = -uy * half, ny = ux * half;
+        const float qx[4] = {ax + nx, bx + nx, bx - nx, ax - nx};
+        const float qy[4] = {ay + ny, by + ny, by - ny, ay - ny};
+        const bool round = _cap == line_cap::round;
+        const auto disc = [half](float cx, float cy, float sy, float &l, float &r) {
+            const float d = sy - cy;
+            if (std::abs(d) >= half)
+                return;
+            const float w = std::sqrt(half * half - d * d);
+            l = std::min(l, cx - w);
+            r = std::max(r, cx + w);
+        };
+
+        float top = std::min(std::min(qy[0], qy[1]), std::min(qy[2], qy[3]));
+        float bottom = std::max(std::max(qy[0], qy[1]), std::max(qy[2], qy[3]));
+        if (round)
+        {
+            top = std::min(top, std::min(ay, by) - half);
+            bottom = std::max(bottom, std::max(ay, by) + half);
+        }
+
+        // Only the rows inside the clip are visited, and each is one
+        // fill_span: axis-aligned lines come out as plain row fills.
+        const int ra = std::max(y1, static_cast<int>(std::ceil(top - 0.5f)));
+        const int rb = std::min(y2, static_cast<int>(std::ceil(bottom - 0.5f)));
+        for (int y = ra; y < rb; ++y)
+        {
+            const float sy = y + 0.5f;
+            float l = HUGE_VALF, r = -HUGE_VALF;
+            for (int i = 0; i < 4; ++i)
+            {
+                const int j = (i + 1) & 3;
+                if ((qy[i] <= sy) == (qy[j] <= sy))
+                    continue;
+                const float x = qx[i] + (sy - qy[i]) * (qx[j] - qx[i]) / (qy[j] - qy[i]);
+                l = std::min(l, x);
+                r = std::max(r, x);
+            }
+            if (round)
+            {
+                disc(ax, ay, sy, l, r);
+                disc(bx, by, sy, l, r);
+            }
+            if (l > r)
+                continue;
+
+            const int xa = std::max(x1, static_cast<int>(std::ceil(l - 0.5f)));
+            const int xb = std::min(x2, static_cast<int>(std::ceil(r - 0.5f)));
+            if (xa < xb)
+                fill_span(xa, xb, y, _ink);
+        }
+    }
+
+    gpx &gpx_img::draw_rect(rect r, bool filled)
+    {
+        int cx1, cy1, cx2, cy2;
+        clip_bounds(cx1, cy1, cx2, cy2);
+
+        const int rx1 = r.p.x;
+        const int ry1 = r.p.y;
+        const int rx2 = rx1 + static_cast<int>(r.d.w);
+        const int ry2 = ry1 + static_cast<int>(r.d.h);
+
+        const int x1 = std::max(cx1, rx1);
+        const int y1 = std::max(cy1, ry1);
+        const int x2 = std::min(cx2, rx2);
+        const int y2 = std::min(cy2, ry2);
+        if (x1 >= x2 || y1 >= y2)
+            return *this;
+
+        if (filled)
+        {
+            for (int y = y1; y < y2; ++y)
+                fill_span(x1, x2, y, _ink);
+            return *this;
+        }
+
+        // Outline: only edges that survive clipping are drawn.
+        if (ry1 >= cy1)
+            fill_span(x1, x2, ry1, _ink);
+        if (ry2 <= cy2 && ry2 - 1 != ry1)
+            fill_span(x1, x2, ry2 - 1, _ink);
+
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        for (int y = y1; y < y2; ++y)
+        {
+            if (rx1 >= cx1)
+                pixels[y * _img.w() + rx1] = _ink;
+            if (rx2 <= cx2 && rx2 - 1 != rx1)
+                pixels[y * _img.w() + rx2 - 1] = _ink;
+        }
+        return *this;
+    }
+
+    gpx &gpx_img::draw_text(const std::string &text, point p)
+    {
+        int x1, y1, x2, y2;
+        clip_bounds(x1, y1, x2, y2);
+        if (x1 >= x2 || y1 >= y2)
+            return *this;
+
+        const rect area(static_cast<coord>(x1), static_cast<coord>(y1),
+                        static_cast<dim>(x2 - x1), static_cast<dim>(y2 - y1));
+        if (detail::img_text_backend_draw(_img, area, _ink, font(), text, p))
+            return *this;
+
+        // Otherwise the built-in bitmap font; p is the top-left corner.
+
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        const int stride = _img.w();
+
+        for (std::size_t i = 0; i < text.size(); ++i)
+        {
+            const int gx0 = p.x + static_cast<int>(i) * detail::glyph_advance;
+            if (gx0 >= x2)
+                break;
+            if (gx0 + detail::glyph_w <= x1)
+                continue;
+
+            uint8_t rows[detail::glyph_h];
+            if (!detail::glyph_rows(text[i], rows))
+                continue;
+
+            for (int gy = 0; gy < detail::glyph_h; ++gy)
+            {
+                const int y = p.y + gy;
+                if (y < y1 || y >= y2 || rows[gy] == 0)
+                    continue;
+
+                for (int gx = 0; gx < detail::glyph_w; ++gx)
+                {
+                    const int x = gx0 + gx;
+                    if (x < x1 || x >= x2)
+                        continue;
+                    if (rows[gy] & (1u << (detail::glyph_w - 1 - gx)))
+                        pixels[y * stride + x] = _ink;
+                }
+            }
+        }
+        return *this;
+    }
+
+    gpx &gpx_img::draw_img(const img &src, point dst)
+    {
+        int cx1, cy1, cx2, cy2;
+        clip_bounds(cx1, cy1, cx2, cy2);
+
+        const int x1 = std::max(cx1, static_cast<int>(dst.x));
+        const int y1 = std::max(cy1, static_cast<int>(dst.y));
+        const int x2 = std::min(cx2, dst.x + static_cast<int>(src.w()));
+        const int y2 = std::min(cy2, dst.y + static_cast<int>(src.h()));
+        if (x1 >= x2 || y1 >= y2)
+            return *this;
+
+        rgba *dst_pixels = const_cast<rgba *>(_img.pixels());
+        const rgba *src_pixels = src.pixels();
+
+        for (int y = y1; y < y2; ++y)
+        {
+            std::memmove(dst_pixels + y * _img.w() + x1,
+                         src_pixels + (y - dst.y) * src.w() + (x1 - dst.x),
+                         static_cast<std::size_t>(x2 - x1) * sizeof(rgba));
+        }
+        return *this;
+    }
+
+    gpx &gpx_img::copy_area(const rect &src, point dst)
+    {
+        rect s = src;
+        point d = dst;
+        if (!detail::clip_copy(_clip, rect(0, 0, _img.w(), _img.h()), s, d))
+            return *this;
+
+        // Walk rows against the direction of the move so overlapping
+        // rows are read before they are overwritten.
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        const int stride = _img.w();
+        const std::size_t bytes = static_cast<std::size_t>(s.d.w) * sizeof(rgba);
+        const bool down = d.y > s.p.y;
+        for (int i = 0; i < s.d.h; ++i)
+        {
+            const int row = down ? s.d.h - 1 - i : i;
+            std::memmove(pixels + (d.y + row) * stride + d.x,
+                         pixels + (s.p.y + row) * stride + s.p.x,
+                         bytes);
+        }
+        return *this;
+    }
+
+    // Path filling accumulates signed area into a float per pixel: an
+    // edge adds its coverage to the cells it crosses and the remainder
+    // of its height to the cell after, so a running sum along the row
+    // gives each pixel's winding-weighted coverage. Rows are resolved a
+    // band at a time, and only between the first and last cell touched.
+    namespace
+    {
+        struct edge
+        {
+            float x0, y0, x1, y1; // In path order; x relative to the area
+        };
+
+        constexpr int band_rows = 16;
+
+        // Adds a-b, cut where it crosses x = 0 and x = w. The parts
+        // outside run straight down the border: everything left of the
+        // area still counts for the rows it spans, and everything right
+        // of it counts for nothing.
+        void add_edge(std::vector<edge> &edges, float ax, float ay, float bx, float by, float w)
+        {
+            if (ay == by)
+                return;
+
+            float ts[4] = {0, 1, 1, 1};
+            int n = 1;
+            if (ax != bx)
+            {
+                for (float edge_x : {0.0f, w})
+                {
+                    const float t = (edge_x - ax) / (bx - ax);
+                    if (t > 0 && t < 1)
+                        ts[n++] = t;
+                }
+            }
+            if (n == 3 && ts[2] < ts[1])
+                std::swap(ts[1], ts[2]);
+            ts[n++] = 1;
+
+            for (int i = 0; i + 1 < n; ++i)
+            {
+                const float y0 = ay + (by - ay) * ts[i];
+                const float y1 = i + 2 == n ? by : ay + (by - ay) * ts[i + 1];
+                if (y0 == y1)
+                    continue;
+                const float x0 = std::min(w, std::max(0.0f, ax + (bx - ax) * ts[i]));
+                const float x1 = std::min(w, std::max(0.0f, i + 2 == n ? bx : ax + (bx - ax) * ts[i + 1]));
+                edges.push_back(edge{x0, y0, x1, y1});
+            }
+        }
+
+        // Accumulates the part of e between rows top and bottom into a,
+        // band_rows rows of stride cells starting at row top.
+        void accumulate(const edge &e, int top, int bottom, float *a, int stride, int *lo, int *hi, float w)
+        {
+            const bool down = e.y0 < e.y1;
+            const float dir = down ? 1.0f : -1.0f;
+            const float px0 = down ? e.x0 : e.x1, py0 = down ? e.y0 : e.y1;
+            const float px1 = down ? e.x1 : e.x0, py1 = down ? e.y1 : e.y0;
+
+            const float ys = std::max(py0, static_cast<float>(top));
+            const float ye = std::min(py1, static_cast<float>(bottom));
+            if (ys >= ye)
+                return;
+
+            const float dxdy = (px1 - px0) / (py1 - py0);
+            float x = px0 + (ys - py0) * dxdy;
+
+            for (int y = static_cast<int>(std::floor(ys)); y < ye; ++y)
+            {
+                const int row = y - top;
+                float *line = a + row * stride;
+                const float dy = std::min(static_cast<float>(y + 1), ye) - std::max(static_cast<float>(y), ys);
+                const float xnext = std::min(w, std::max(0.0f, x + dxdy * dy));
+                const float d = dy * dir;
+
+                const float x0 = std::min(x, xnext);
+                const float x1 = std::max(x, xnext);
+                const float x0floor = std::floor(x0);
+                const int x0i = static_cast<int>(x0floor);
+                const int x1i = static_cast<int>(std::ceil(x1));
+
+                if (x1i <= x0i + 1)
+                {
+                    // Within one cell: the part right of the edge's
+                    // middle is this cell's, the rest spills over.
+                    const float xmf = 0.5f * (x + xnext) - x0floor;
+                    line[x0i] += d - d * xmf;
+                    line[x0i + 1] += d * xmf;
+                    lo[row] = std::min(lo[row], x0i);
+                    hi[row] = std::max(hi[row], x0i + 1);
+                }
+                else
+                {
+                    const float s = 1 / (x1 - x0);
+                    const float x0f = x0 - x0floor;
+                    const float a0 = 0.5f * s * (1 - x0f) * (1 - x0f);
+                    const float x1f = x1 - static_cast<float>(x1i) + 1;
+                    const float am = 0.5f * s * x1f * x1f;
+
+                    line[x0i] += d * a0;
+                    if (x1i == x0i + 2)
+                        line[x0i + 1] += d * (1 - a0 - am);
+                    else
+                    {
+                        const float a1 = s * (1.5f - x0f);
+                        line[x0i + 1] += d * (a1 - a0);
+                        for (int xi = x0i + 2; xi < x1i - 1; ++xi)
+                            line[xi] += d * s;
+                        const float a2 = a1 + static_cast<float>(x1i - x0i - 3) * s;
+                        line[x1i - 1] += d * (1 - a2 - am);
+                    }
+                    line[x1i] += d * am;
+                    lo[row] = std::min(lo[row], x0i);
+                    hi[row] = std::max(hi[row], x1i);
+                }
+                x = xnext;
+            }
+        }
+
+        // Turns a[0, n) into coverage in place: the running sum, folded
+        // by the fill rule and capped at 1.
+        void resolve(float *a, int n, fill_rule rule)
+        {
+            const bool even_odd = rule == fill_rule::even_odd;
+            float sum = 0;
+            int x = 0;
+
+#if defined(__SSE2__)
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            __m128 carry = _mm_setzero_ps();
+            for (; x + 4 <= n; x += 4)
+            {
+                __m128 v = _mm_loadu_ps(a + x);
+                v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)));
+                v = _mm_add_ps(v, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8)));
+                v = _mm_add_ps(v, carry);
+                carry = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+
+                __m128 c = _mm_andnot_ps(sign, v);
+                if (even_odd)
+                {
+                    const __m128 pairs = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(c, half)));
+                    c = _mm_sub_ps(c, _mm_mul_ps(pairs, two));
+                    c = _mm_min_ps(c, _mm_sub_ps(two, c));
+                }
+                else
+                    c = _mm_min_ps(c, one);
+                _mm_storeu_ps(a + x, c);
+            }
+            sum = _mm_cvtss_f32(carry);
+#endif
+
+            for (; x < n; ++x)
+            {
+                sum += a[x];
+                float c = std::abs(sum);
+                if (even_odd)
+                {
+                    c -= 2 * std::floor(c * 0.5f);
+                    c = std::min(c, 2 - c);
+                }
+                else
+                    c = std::min(c, 1.0f);
+                a[x] = c;
+            }
+        }
+
+        uint8_t mix(uint8_t d, uint8_t s, unsigned k)
+        {
+            return static_cast<uint8_t>((s * k + d * (255 - k) + 127) / 255);
+        }
+
+        // Positive signed area in screen coordinates, so overlapping
+        // pieces of a stroke all wind the same way.
+        void add_piece(path &out, std::initializer_list<path::vertex> vs)
+        {
+            const path::vertex *v = vs.begin();
+            const std::size_t n = vs.size();
+            float area = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                area += v[i].x * v[(i + 1) % n].y - v[(i + 1) % n].x * v[i].y;
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const path::vertex &p = area >= 0 ? v[i] : v[n - 1 - i];
+                if (i == 0)
+                    out.move_to(p.x, p.y);
+                else
+                    out.line_to(p.x, p.y);
+            }
+            out.close();
+        }
+    }
+
+    gpx &gpx_img::fill_path(const path &p, fill_rule rule)
+    {
+        int cx1, cy1, cx2, cy2;
+        clip_bounds(cx1, cy1, cx2, cy2);
+        const auto &v = p.vertices();
+        if (cx1 >= cx2 || cy1 >= cy2 || v.empty())
+            return *this;
+
+        float minx = v[0].x, maxx = v[0].x, miny = v[0].y, maxy = v[0].y;
+        for (const auto &q : v)
+        {
+            minx = std::min(minx, q.x);
+            maxx = std::max(maxx, q.x);
+            miny = std::min(miny, q.y);
+            maxy = std::max(maxy, q.y);
+        }
+
+        // Only pixels inside both the clip and the path's bounds.
+        const int x1 = std::max<float>(cx1, std::floor(minx));
+        const int x2 = std::min<float>(cx2, std::ceil(maxx));
+        const int y1 = std::max<float>(cy1, std::floor(miny));
+        const int y2 = std::min<float>(cy2, std::ceil(maxy));
+        if (x1 >= x2 || y1 >= y2)
+            return *this;
+
+        const int w = x2 - x1;
+        const float fw = static_cast<float>(w);
+        std::vector<edge> edges;
+        edges.reserve(v.size());
+        for (const auto &c : p.contours())
+        {
+            for (std::size_t i = 0; i < c.count && c.count > 1; ++i)
+            {
+                const path::vertex &a = v[c.first + i];
+                const path::vertex &b = v[c.first + (i + 1) % c.count];
+                add_edge(edges, a.x - x1, a.y, b.x - x1, b.y, fw);
+            }
+        }
+        if (edges.empty())
+            return *this;
+
+        const auto top = [](const edge &e) { return std::min(e.y0, e.y1); };
+        const auto bottom = [](const edge &e) { return std::max(e.y0, e.y1); };
+        std::sort(edges.begin(), edges.end(), [&](const edge &a, const edge &b) { return top(a) < top(b); });
+
+        // Two spare cells take what spills past the right border.
+        const int stride = w + 2;
+        std::vector<float> acc(static_cast<std::size_t>(stride) * band_rows, 0.0f);
+        int lo[band_rows], hi[band_rows];
+
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        const rgba ink = _ink;
+        std::vector<const edge *> active;
+        std::size_t next = 0;
+
+        for (int band = y1; band < y2; band += band_rows)
+        {
+            const int band_end = std::min(band + band_rows, y2);
+
+            active.erase(std::remove_if(active.begin(), active.end(),
+                                        [&](const edge *e) { return bottom(*e) <= band; }),
+                         active.end());
+            for (; next < edges.size() && top(edges[next]) < band_end; ++next)
+            {
+                if (bottom(edges[next]) > band)
+                    active.push_back(&edges[next]);
+            }
+
+            std::fill(lo, lo + band_rows, stride);
+            std::fill(hi, hi + band_rows, -1);
+            for (const edge *e : active)
+                accumulate(*e, band, band_end, acc.data(), stride, lo, hi, fw);
+
+            for (int row = 0; row < band_end - band; ++row)
+            {
+                if (hi[row] < 0)
+                    continue;
+
+                // Past the last touched cell the sum is back to zero.
+                float *a = acc.data() + row * stride;
+                const int from = lo[row];
+                const int to = std::min(hi[row] + 1, w);
+                resolve(a + from, to - from, rule);
+
+                rgba *out = pixels + (band + row) * _img.w() + x1;
+                for (int x = from; x < to; ++x)
+                {
+                    const unsigned k = static_cast<unsigned>(a[x] * 255 + 0.5f);
+                    if (k >= 255)
+                        out[x] = ink;
+                    else if (k > 0)
+                    {
+                        rgba &d = out[x];
+                        d = rgba(mix(d.r, ink.r, k), mix(d.g, ink.g, k), mix(d.b, ink.b, k), mix(d.a, ink.a, k));
+                    }
+                }
+                std::fill(a + from, a + hi[row] + 1, 0.0f);
+            }
+        }
+        return *this;
+    }
+
+    gpx &gpx_img::draw_path(const path &p)
+    {
+        // Every segment becomes a quad pen wide, every corner a bevel and
+        // every open end a cap, and the lot is filled in one pass.
+        const float half = std::max<float>(1, pen()) * 0.5f;
+        const auto &v = p.vertices();
+        path outline;
+
+        for (const auto &c : p.contours())
+        {
+            const std::size_t segments = c.closed && c.count > 2 ? c.count : c.count - (c.count > 0);
+            path::vertex prev_n{0, 0};
+            path::vertex first_n{0, 0};
+            path::vertex first_a{0, 0};
+            path::vertex last_b{0, 0};
+            bool have_prev = false;
+
+            for (std::size_t i = 0; i < segments; ++i)
+            {
+                const path::vertex &a = v[c.first + i];
+                const path::vertex &b = v[c.first + (i + 1) % c.count];
+                const float len = std::hypot(b.x - a.x, b.y - a.y);
+                if (len == 0)
+                    continue;
+
+                const path::vertex n{-(b.y - a.y) / len * half, (b.x - a.x) / len * half};
+                add_piece(outline, {{a.x + n.x, a.y + n.y}, {b.x + n.x, b.y + n.y},
+                                    {b.x - n.x, b.y - n.y}, {a.x - n.x, a.y - n.y}});
+
+                if (have_prev)
+                {
+                    add_piece(outline, {a, {a.x + prev_n.x, a.y + prev_n.y}, {a.x + n.x, a.y + n.y}});
+                    add_piece(outline, {a, {a.x - prev_n.x, a.y - prev_n.y}, {a.x - n.x, a.y - n.y}});
+                }
+                else
+                {
+                    first_n = n;
+                    first_a = a;
+                }
+                prev_n = n;
+                last_b = b;
+                have_prev = true;
+            }
+
+            if (!have_prev)
+                continue;
+
+            if (c.closed && c.count > 2)
+            {
+                const path::vertex &a = v[c.first];
+                add_piece(outline, {a, {a.x + prev_n.x, a.y + prev_n.y}, {a.x + first_n.x, a.y + first_n.y}});
+                add_piece(outline, {a, {a.x - prev_n.x, a.y - prev_n.y}, {a.x - first_n.x, a.y - first_n.y}});
+            }
+            else if (_cap == line_cap::square)
+            {
+                // The normal turned back is half a pen along the line.
+                const path::vertex d0{first_n.y, -first_n.x};
+                const path::vertex d1{prev_n.y, -prev_n.x};
+                const path::vertex &a = first_a;
+                const path::vertex &b = last_b;
+                add_piece(outline, {{a.x + first_n.x, a.y + first_n.y}, {a.x + first_n.x - d0.x, a.y + first_n.y - d0.y},
+                                    {a.x - first_n.x - d0.x, a.y - first_n.y - d0.y}, {a.x - first_n.x, a.y - first_n.y}});
+                add_piece(outline, {{b.x + prev_n.x, b.y + prev_n.y}, {b.x + prev_n.x + d1.x, b.y + prev_n.y + d1.y},
+                                    {b.x - prev_n.x + d1.x, b.y - prev_n.y + d1.y}, {b.x - prev_n.x, b.y - prev_n.y}});
+            }
+            else if (_cap == line_cap::round)
+            {
+                outline.arc(first_a.x, first_a.y, half, 0, 2 * 3.14159265f).close();
+                outline.arc(last_b.x, last_b.y, half, 0, 2 * 3.14159265f).close();
+            }
+        }
+
+        return fill_path(outline, fill_rule::nonzero);
+    }
+
+    namespace
+    {
+        // out[i] = lut[index of t0 + (first + i) * dt], four pixels a
+        // step; the same sum as the default painter's, so both pick the
+        // same entries.
+        void linear_span(rgba *out, int n, float t0, int first, float dt, const rgba *lut)
+        {
+            int i = 0;
+
+#if defined(__SSE2__)
+            const __m128 lanes = _mm_setr_ps(0, 1, 2, 3);
+            const __m128 t0v = _mm_set1_ps(t0);
+            const __m128 dtv = _mm_set1_ps(dt);
+            const __m128 scale = _mm_set1_ps(255.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 zero = _mm_setzero_ps();
+            alignas(16) int32_t idx[4];
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 x = _mm_add_ps(_mm_set1_ps(static_cast<float>(first + i)), lanes);
+                __m128 t = _mm_add_ps(_mm_mul_ps(_mm_add_ps(t0v, _mm_mul_ps(x, dtv)), scale), half);
+                t = _mm_min_ps(_mm_max_ps(t, zero), scale);
+                _mm_store_si128(reinterpret_cast<__m128i *>(idx), _mm_cvttps_epi32(t));
+                out[i] = lut[idx[0]];
+                out[i + 1] = lut[idx[1]];
+                out[i + 2] = lut[idx[2]];
+                out[i + 3] = lut[idx[3]];
+            }
+#endif
+
+            for (; i < n; ++i)
+                out[i] = lut[detail::gradient_index(t0 + (first + i) * dt)];
+        }
+
+        // out[i] = lut[index of |(fx0 + i * dfx, fy)|], with fy2 = fy * fy.
+        void radial_span(rgba *out, int n, float fx0, float dfx, float fy2, const rgba *lut)
+        {
+            int i = 0;
+
+#if defined(__SSE2__)
+            const __m128 lanes = _mm_setr_ps(0, 1, 2, 3);
+            const __m128 fx0v = _mm_set1_ps(fx0);
+            const __m128 dfxv = _mm_set1_ps(dfx);
+            const __m128 fy2v = _mm_set1_ps(fy2);
+            const __m128 scale = _mm_set1_ps(255.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            alignas(16) int32_t idx[4];
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 fx = _mm_add_ps(fx0v, _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lanes), dfxv));
+                __m128 t = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(fx, fx), fy2v));
+                t = _mm_min_ps(_mm_add_ps(_mm_mul_ps(t, scale), half), scale);
+                _mm_store_si128(reinterpret_cast<__m128i *>(idx), _mm_cvttps_epi32(t));
+                out[i] = lut[idx[0]];
+                out[i + 1] = lut[idx[1]];
+                out[i + 2] = lut[idx[2]];
+                out[i + 3] = lut[idx[3]];
+            }
+#endif
+
+            for (; i < n; ++i)
+            {
+                const float fx = fx0 + i * dfx;
+                out[i] = lut[detail::gradient_index(std::sqrt(fx * fx + fy2))];
+            }
+        }
+    }
+
+    gpx &gpx_img::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        int x1, y1, x2, y2;
+        clip_bounds(x1, y1, x2, y2);
+        x1 = std::max(x1, static_cast<int>(r.p.x));
+        y1 = std::max(y1, static_cast<int>(r.p.y));
+        x2 = std::min(x2, r.p.x + static_cast<int>(r.d.w));
+        y2 = std::min(y2, r.p.y + static_cast<int>(r.d.h));
+        if (x1 >= x2 || y1 >= y2)
+            return *this;
+
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        const rgba *lut = g.table();
+        const int n = x2 - x1;
+
+        if (g.kind() == gradient_kind::linear)
+        {
+            const detail::gradient_map m = detail::linear_gradient_map(g, r.d.w, r.d.h);
+            for (int y = y1; y < y2; ++y)
+            {
+                const float t = m.t0 + (y - r.p.y) * m.dy;
+                if (m.dx == 0)
+                    fill_span(x1, x2, y, lut[detail::gradient_index(t)]);
+                else
+                    linear_span(pixels + y * _img.w() + x1, n, t, x1 - r.p.x, m.dx, lut);
+            }
+            return *this;
+        }
+
+        const float hw = r.d.w * 0.5f;
+        const float hh = r.d.h * 0.5f;
+        for (int y = y1; y < y2; ++y)
+        {
+            const float fy = (y - r.p.y + 0.5f) / hh - 1;
+            radial_span(pixels + y * _img.w() + x1, n, (x1 - r.p.x + 0.5f) / hw - 1, 1 / hw, fy * fy, lut);
+        }
+        return *this;
+    }
+
+    gpx &gpx_img::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        int x1, y1, x2, y2;
+        clip_bounds(x1, y1, x2, y2);
+        x1 = std::max(x1, static_cast<int>(r.p.x));
+        y1 = std::max(y1, static_cast<int>(r.p.y));
+        x2 = std::min(x2, r.p.x + static_cast<int>(r.d.w));
+        y2 = std::min(y2, r.p.y + static_cast<int>(r.d.h));
+        if (x1 >= x2 || y1 >= y2)
+            return *this;
+
+        // Each row is the tile's row copied along, a tile width at a time.
+        const int tw = tile.w();
+        const int th = tile.h();
+        const auto wrap = [](int v, int m) { return ((v % m) + m) % m; };
+        const int col = wrap(x1 - origin.x, tw);
+
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        for (int y = y1; y < y2; ++y)
+        {
+            const rgba *src = tile.pixels() + wrap(y - origin.y, th) * tw;
+            rgba *out = pixels + y * _img.w() + x1;
+            int left = x2 - x1;
+
+            int run = std::min(tw - col, left);
+            std::memcpy(out, src + col, run * sizeof(rgba));
+            for (out += run, left -= run; left > 0; out += run, left -= run)
+            {
+                run = std::min(tw, left);
+                std::memcpy(out, src, run * sizeof(rgba));
+            }
+        }
+        return *this;
+    }
+
+    gpx &gpx_img::draw_img_nine_slice(const img &src, const rect &center, const rect &dst)
+    {
+        int x1, y1, x2, y2;
+        clip_bounds(x1, y1, x2, y2);
+        x1 = std::max(x1, static_cast<int>(dst.p.x));
+        y1 = std::max(y1, static_cast<int>(dst.p.y));
+        x2 = std::min(x2, dst.p.x + static_cast<int>(dst.d.w));
+        y2 = std::min(y2, dst.p.y + static_cast<int>(dst.d.h));
+        if (x1 >= x2 || y1 >= y2 || src.w() <= 0 || src.h() <= 0)
+            return *this;
+
+        // An empty center keeps its place: the middle repeats the pixel
+        // after it.
+        const int cx1 = std::max(0, std::min<int>(center.p.x, src.w()));
+        const int cy1 = std::max(0, std::min<int>(center.p.y, src.h()));
+        const int cx2 = std::max(cx1, std::min<int>(center.p.x + center.d.w, src.w()));
+        const int cy2 = std::max(cy1, std::min<int>(center.p.y + center.d.h, src.h()));
+        const detail::nine_slice_axis cols(src.w(), cx1, src.w() - cx2, dst.d.w);
+        const detail::nine_slice_axis rows(src.h(), cy1, src.h() - cy2, dst.d.h);
+
+        // Each row is three bands: the corners or edges at either end
+        // are copies, and the middle is a fill when one source pixel
+        // stretches across it. Rows whose source row matches the one
+        // before are copies of the row above.
+        const int head_end = std::min(x2, dst.p.x + cols.head);
+        const int tail_start = std::max(x1, dst.p.x + cols.n - cols.tail);
+        const int mid_start = std::max(x1, head_end);
+        const int mid_end = std::min(x2, tail_start);
+        const bool mid_fill = cols.middle <= 1;
+        const bool compare_rows = src.w() <= x2 - x1;
+
+        rgba *pixels = const_cast<rgba *>(_img.pixels());
+        const int stride = _img.w();
+        const std::size_t bytes = static_cast<std::size_t>(x2 - x1) * sizeof(rgba);
+        const rgba *last = nullptr;
+        for (int y = y1; y < y2; ++y)
+        {
+            const rgba *in = src.pixels() + rows.at(y - dst.p.y) * src.w();
+            rgba *out = pixels + y * stride;
+            if (last && (in == last || (compare_rows && !std::memcmp(in, last, src.w() * sizeof(rgba)))))
+            {
+                std::memcpy(out + x1, out + x1 - stride, bytes);
+                continue;
+            }
+            last = in;
+
+            if (x1 < head_end)
+                std::memcpy(out + x1, in + (x1 - dst.p.x), static_cast<std::size_t>(head_end - x1) * sizeof(rgba));
+            if (mid_start < mid_end && mid_fill)
+                std::fill(out + mid_start, out + mid_end, in[cols.at(mid_start - dst.p.x)]);
+            else
+                for (int x = mid_start; x < mid_end; ++x)
+                    out[x] = in[cols.at(x - dst.p.x)];
+            if (tail_start < x2)
+            {
+                const int from = std::max(x1, tail_start);
+                std::memcpy(out + from, in + cols.at(from - dst.p.x), static_cast<std::size_t>(x2 - from) * sizeof(rgba));
+            }
+        }
+        return *this;
+    }
+
+} // namespace native
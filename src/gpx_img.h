@@ -5,6 +5,9 @@
 namespace native
 {
 
+    // Software renderer for img.
+    // Touches only the target pixels and its own state: no display, no
+    // backend globals. One instance per thread on disjoint images is safe.
     class gpx_img : public gpx
     {
     public:
@@ -20,10 +23,28 @@ namespace native
         gpx &draw_rect(rect r, bool filled = false) override;
         gpx &draw_text(const std::string &text, point p) override;
         gpx &draw_img(const img &src, point dst) override;
+        gpx &copy_area(const rect &src, point dst) override;
+
+        // Anti-aliased: edge pixels take the ink in proportion to how
+        // much of them the path covers.
+        gpx &fill_path(const path &p, fill_rule rule = fill_rule::nonzero) override;
+        gpx &draw_path(const path &p) override;
+
+        gpx &fill_rect_gradient(const rect &r, const gradient &g) override;
+        gpx &fill_rect_pattern(const rect &r, const img &tile, point origin = {0, 0}) override;
+        gpx &draw_img_nine_slice(const img &src, const rect &center, const rect &dst) override;
 
     private:
         const img &_img; // Non-null reference to parent image
         rect _clip;
+
+        // Clip rectangle intersected with the image, as half-open bounds.
+        void clip_bounds(int &x1, int &y1, int &x2, int &y2) const;
+        void fill_span(int x1, int x2, int y, rgba color);
+
+        // Lines of pen 0 or 1, and wider ones, within the clip bounds.
+        void hairline(point from, point to, int x1, int y1, int x2, int y2);
+        void wide_line(point from, point to, int x1, int y1, int x2, int y2);
     };
 
 } // namespace native
@@ -19,11 +19,20 @@ namespace native
         gpx &draw_rect(rect r, bool filled = false) override;
         gpx &draw_text(const std::string &text, point p) override;
         gpx &draw_img(const img &src, point dst) override;
+        gpx &copy_area(const rect &src, point dst) override;
+        gpx &fill_path(const path &p, fill_rule rule = fill_rule::nonzero) override;
+        gpx &draw_path(const path &p) override;
+        gpx &fill_rect_gradient(const rect &r, const gradient &g) override;
+        gpx &fill_rect_pattern(const rect &r, const img &tile, point origin = {0, 0}) override;
 
     private:
         wnd *_wnd;
         rect _clip;
         point _offset;
+
+        // Slot of _wnd in the backend's drawing-state bindings, so each
+        // primitive resolves its state without a hash probe.
+        mutable std::size_t _state_hint = 0;
     };
 
 }
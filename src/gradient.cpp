@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include <native.h>
+
+#include "gradient_map.h"
+
+namespace native
+{
+    static uint8_t lerp(uint8_t a, uint8_t b, float t)
+    {
+        return static_cast<uint8_t>(std::lround(a + (b - a) * t));
+    }
+
+    gradient::gradient(gradient_kind kind, std::vector<stop> stops, float angle)
+        : _kind(kind),
+          _angle(angle),
+          _stops(std::move(stops))
+    {
+        static std::atomic<uint64_t> next_serial{1};
+        _serial = next_serial++;
+
+        std::stable_sort(_stops.begin(), _stops.end(),
+                         [](const stop &a, const stop &b) { return a.at < b.at; });
+
+        // Before the first stop and after the last, the ramp is flat.
+        std::size_t s = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            const float t = i / 255.0f;
+            while (s < _stops.size() && _stops[s].at <= t)
+                ++s;
+
+            if (_stops.empty())
+                _table[i] = rgba();
+            else if (s == 0)
+                _table[i] = _stops.front().color;
+            else if (s == _stops.size())
+                _table[i] = _stops.back().color;
+            else
+            {
+                const stop &a = _stops[s - 1];
+                const stop &b = _stops[s];
+                const float k = (t - a.at) / (b.at - a.at);
+                _table[i] = rgba(lerp(a.color.r, b.color.r, k), lerp(a.color.g, b.color.g, k),
+                                 lerp(a.color.b, b.color.b, k), lerp(a.color.a, b.color.a, k));
+            }
+        }
+    }
+
+    gradient_kind gradient::kind() const
+    {
+        return _kind;
+    }
+
+    float gradient::angle() const
+    {
+        return _angle;
+    }
+
+    const std::vector<gradient::stop> &gradient::stops() const
+    {
+        return _stops;
+    }
+
+    const rgba *gradient::table() const
+    {
+        return _table;
+    }
+
+    uint64_t gradient::serial() const
+    {
+        return _serial;
+    }
+
+    const img &gradient::image(dim w, dim h) const
+    {
+        if (!_image || _image->w() != w || _image->h() != h)
+        {
+            _image = std::make_unique<img>(w, h);
+            _image->create_gpx()->fill_rect_gradient(rect(0, 0, w, h), *this);
+        }
+        return *_image;
+    }
+
+    gpx &gpx::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        const rect area = clip().intersect(r);
+        if (area.d.w == 0 || area.d.h == 0)
+            return *this;
+
+        const detail::gradient_map m = detail::linear_gradient_map(g, r.d.w, r.d.h);
+        if (g.kind() != gradient_kind::linear || (m.dx != 0 && m.dy != 0))
+            return draw_img(g.image(r.d.w, r.d.h), r.p);
+
+        // One rect per run of rows (or columns) that share a colour.
+        const rgba ink = _ink;
+        const bool rows = m.dx == 0;
+        const int first = rows ? area.p.y - r.p.y : area.p.x - r.p.x;
+        const int last = first + (rows ? area.d.h : area.d.w);
+        const float step = rows ? m.dy : m.dx;
+
+        int i = first;
+        while (i < last)
+        {
+            const int index = detail::gradient_index(m.t0 + i * step);
+            int j = i + 1;
+            while (j < last && detail::gradient_index(m.t0 + j * step) == index)
+                ++j;
+
+            set_ink(g.table()[index]);
+            if (rows)
+                draw_rect(rect(area.p.x, static_cast<coord>(r.p.y + i), area.d.w, static_cast<dim>(j - i)), true);
+            else
+                draw_rect(rect(static_cast<coord>(r.p.x + i), area.p.y, static_cast<dim>(j - i), area.d.h), true);
+            i = j;
+        }
+
+        set_ink(ink);
+        return *this;
+    }
+
+    gpx &gpx::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        const rect area = clip().intersect(r);
+        if (area.d.w == 0 || area.d.h == 0)
+            return *this;
+
+        const int tw = tile.w();
+        const int th = tile.h();
+        const auto floor_to = [](int v, int o, int step) {
+            const int d = v - o;
+            return o + (d >= 0 ? d / step : -((step - 1 - d) / step)) * step;
+        };
+
+        for (int ty = floor_to(area.p.y, origin.y, th); ty < area.p.y + area.d.h; ty += th)
+        {
+            for (int tx = floor_to(area.p.x, origin.x, tw); tx < area.p.x + area.d.w; tx += tw)
+            {
+                const rect part = area.intersect(rect(static_cast<coord>(tx), static_cast<coord>(ty),
+                                                      static_cast<dim>(tw), static_cast<dim>(th)));
+                if (part.d.w == tw && part.d.h == th)
+                {
+                    draw_img(tile, part.p);
+                    continue;
+                }
+
+                // Tiles cut by the area go out as cropped copies, since
+                // not every painter clips draw_img().
+                img crop(part.d.w, part.d.h);
+                for (int y = 0; y < part.d.h; ++y)
+                    std::copy_n(tile.pixels() + (part.p.y - ty + y) * tw + (part.p.x - tx), part.d.w,
+                                crop.pixels() + y * part.d.w);
+                draw_img(crop, part.p);
+            }
+        }
+        return *this;
+    }
+
+namespace detail
+{
+    gradient_map linear_gradient_map(const gradient &g, dim w, dim h)
+    {
+        float c = std::cos(g.angle());
+        float s = std::sin(g.angle());
+        if (std::abs(c) < 1e-6f)
+            c = 0;
+        if (std::abs(s) < 1e-6f)
+            s = 0;
+
+        // The ramp spans the rect's extent along the direction, centred
+        // on the rect's centre; pixels are sampled at their centres.
+        const float span = std::abs(w * c) + std::abs(h * s);
+        if (span == 0)
+            return gradient_map{0, 0, 0};
+
+        const float dx = c / span;
+        const float dy = s / span;
+        return gradient_map{0.5f + (0.5f - w * 0.5f) * dx + (0.5f - h * 0.5f) * dy, dx, dy};
+    }
+}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <native.h>
+
+namespace native
+{
+namespace detail
+{
+    // Where a pixel falls on a gradient over a w x h rect. For linear
+    // gradients, pixel (x, y) of the rect sits at t0 + x * dx + y * dy;
+    // for radial ones, (x + 0.5) / (w / 2) - 1 and the same for y, taken
+    // as a vector, have length t. Horizontal and vertical gradients come
+    // out with dy or dx exactly 0.
+    struct gradient_map
+    {
+        float t0;
+        float dx;
+        float dy;
+    };
+
+    gradient_map linear_gradient_map(const gradient &g, dim w, dim h);
+
+    // Table entry for position t, clamped to the ends of the ramp.
+    inline int gradient_index(float t)
+    {
+        const float i = t * 255 + 0.5f;
+        return i <= 0 ? 0 : i >= 255 ? 255 : static_cast<int>(i);
+    }
+}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace native
+{
+
+    // Slot table that hands out generation-checked uint32_t handles.
+    // Resolving a handle is an index and a compare, with no hashing. A
+    // handle whose slot was released, even if the slot has since been
+    // reused, resolves to nullptr. Handle 0 is never issued, so it can
+    // stand for "none".
+    template <typename T>
+    class handle_table
+    {
+    public:
+        uint32_t insert(T *p)
+        {
+            uint32_t index;
+            if (!_free.empty())
+            {
+                index = _free.back();
+                _free.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(_slots.size());
+                _slots.push_back(slot{});
+            }
+
+            _slots[index].p = p;
+            return (_slots[index].generation << index_bits) | index;
+        }
+
+        T *get(uint32_t handle) const
+        {
+            const uint32_t index = handle & index_mask;
+            if (index >= _slots.size())
+                return nullptr;
+
+            const slot &s = _slots[index];
+            return s.generation == (handle >> index_bits) ? s.p : nullptr;
+        }
+
+        // Frees the slot and returns what it held, or nullptr for a stale
+        // handle.
+        T *release(uint32_t handle)
+        {
+            T *p = get(handle);
+            if (!p)
+                return nullptr;
+
+            slot &s = _slots[handle & index_mask];
+            s.p = nullptr;
+            s.generation = s.generation == max_generation ? 1 : s.generation + 1;
+            _free.push_back(handle & index_mask);
+            return p;
+        }
+
+    private:
+        static constexpr uint32_t index_bits = 20;
+        static constexpr uint32_t index_mask = (1u << index_bits) - 1;
+        static constexpr uint32_t max_generation = (1u << (32 - index_bits)) - 1;
+
+        struct slot
+        {
+            T *p = nullptr;
+            uint32_t generation = 1;
+        };
+
+        std::vector<slot> _slots;
+        std::vector<uint32_t> _free;
+    };
+
+} // namespace native
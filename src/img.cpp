@@ -1,6 +1,7 @@
 #include <stdexcept>
 
 #include <native.h>
+#include "gpx_img.h"
 
 namespace native
 {
@@ -13,4 +14,16 @@ namespace native
 
     img::~img() = default;
 
-} // namespace native
\ No newline at end of file
+    gpx &img::get_gpx() const
+    {
+        std::call_once(_gpx_once, [this]()
+                       { _gpx = create_gpx(); });
+        return *_gpx;
+    }
+
+    std::unique_ptr<gpx> img::create_gpx() const
+    {
+        return std::make_unique<gpx_img>(*this);
+    }
+
+} // namespace native
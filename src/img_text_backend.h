@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include <native.h>
+
+namespace native
+{
+namespace detail
+{
+    // Draws text into target with the platform's own text renderer, in
+    // ink and font f, at p as the backend's gpx_wnd::draw_text() places
+    // it. Only pixels inside clip, already within target, are written.
+    // Needs no window, and is safe to call from several threads on
+    // different images. Returns false where the platform has no text
+    // renderer that works without a display; gpx_img then uses the
+    // built-in bitmap font.
+    bool img_text_backend_draw(const img &target,
+                               const rect &clip,
+                               rgba ink,
+                               const font_t &f,
+                               const std::string &text,
+                               point p);
+}
+}
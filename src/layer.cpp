@@ -0,0 +1,57 @@
+#include <native.h>
+
+namespace native
+{
+
+    layer::layer(dim w, dim h)
+        : _img(std::make_unique<img>(w, h))
+    {
+    }
+
+    void layer::invalidate()
+    {
+        _valid = false;
+    }
+
+    bool layer::valid() const
+    {
+        return _valid;
+    }
+
+    void layer::resize(dim w, dim h)
+    {
+        if (w == _img->w() && h == _img->h())
+            return;
+
+        _img = std::make_unique<img>(w, h);
+        _valid = false;
+    }
+
+    size layer::dimensions() const
+    {
+        return size(static_cast<dim>(_img->w()), static_cast<dim>(_img->h()));
+    }
+
+    const img &layer::image()
+    {
+        if (_valid)
+            return *_img;
+
+        // Same contract as a window paint: white background, full area.
+        const rect r(0, 0, static_cast<dim>(_img->w()), static_cast<dim>(_img->h()));
+        gpx &g = _img->get_gpx();
+        g.set_clip(r);
+        g.clear(rgba(255, 255, 255, 255));
+        wnd_paint_event e(r, g);
+        on_paint.emit(e);
+
+        _valid = true;
+        return *_img;
+    }
+
+    gpx &layer::draw(gpx &g, point dst)
+    {
+        return g.draw_img(image(), dst);
+    }
+
+} // namespace native
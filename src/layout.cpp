@@ -5,6 +5,8 @@
 
 #include <native.h>
 
+#include "bindings.h"
+
 namespace
 {
     template <typename T>
@@ -43,32 +45,48 @@ namespace
             tracks.push_back(native::grid_length::star());
     }
 
-    std::vector<int> compute_track_sizes(const std::vector<native::grid_length> &defs, int total)
+    // Fills edges with the n + 1 track boundaries starting at origin, so
+    // track i spans [edges[i], edges[i + 1]) and a span of tracks is one
+    // subtraction.
+    // content holds the size of each auto track; it may be empty when
+    // there are none.
+    void compute_track_edges(const std::vector<native::grid_length> &defs,
+                             const std::vector<int> &content,
+                             int total,
+                             int origin,
+                             std::vector<int> &edges)
     {
         const int available = std::max(0, total);
         const int n = static_cast<int>(defs.size());
 
+        edges.assign(static_cast<std::size_t>(std::max(1, n)) + 1, 0);
         if (n <= 0)
-            return {available};
-
-        std::vector<int> sizes(static_cast<std::size_t>(n), 0);
-
-        float star_sum = 0.0f;
-        for (const auto &d : defs)
         {
-            const float v = std::max(0.0f, d.value);
-            if (d.type == native::grid_length::unit::star)
-                star_sum += v;
+            edges[0] = origin;
+            edges[1] = origin + available;
+            return;
         }
 
+        // Track sizes are accumulated in edges[1..n] and turned into
+        // offsets at the end.
+        float star_sum = 0.0f;
+        int star_count = 0;
         int fixed_used = 0;
         for (int i = 0; i < n; ++i)
         {
             const auto &d = defs[static_cast<std::size_t>(i)];
-            if (d.type == native::grid_length::unit::pixel)
+            const float v = std::max(0.0f, d.value);
+            if (d.type == native::grid_length::unit::star)
             {
-                const int sz = static_cast<int>(std::lround(std::max(0.0f, d.value)));
-                sizes[static_cast<std::size_t>(i)] = sz;
+                star_sum += v;
+                ++star_count;
+            }
+            else
+            {
+                const int sz = d.type == native::grid_length::unit::pixel
+                                   ? static_cast<int>(std::lround(v))
+                                   : content[static_cast<std::size_t>(i)];
+                edges[static_cast<std::size_t>(i) + 1] = sz;
                 fixed_used += sz;
             }
         }
@@ -78,7 +96,6 @@ namespace
         if (star_sum > 0.0f)
         {
             int star_used = 0;
-            std::vector<int> star_indices;
             for (int i = 0; i < n; ++i)
             {
                 const auto &d = defs[static_cast<std::size_t>(i)];
@@ -87,88 +104,75 @@ namespace
 
                 const float weight = std::max(0.0f, d.value);
                 const int sz = static_cast<int>(std::floor((remaining * weight) / star_sum));
-                sizes[static_cast<std::size_t>(i)] = sz;
+                edges[static_cast<std::size_t>(i) + 1] = sz;
                 star_used += sz;
-                star_indices.push_back(i);
             }
 
+            // Rounding leftovers go one pixel at a time to the star
+            // tracks in order.
             int left = remaining - star_used;
-            for (int j = 0; left > 0 && !star_indices.empty(); ++j, --left)
+            while (left > 0 && star_count > 0)
             {
-                const int idx = star_indices[static_cast<std::size_t>(j % static_cast<int>(star_indices.size()))];
-                ++sizes[static_cast<std::size_t>(idx)];
+                for (int i = 0; i < n && left > 0; ++i)
+                {
+                    if (defs[static_cast<std::size_t>(i)].type != native::grid_length::unit::star)
+                        continue;
+                    ++edges[static_cast<std::size_t>(i) + 1];
+                    --left;
+                }
             }
         }
-        else if (n > 0)
+        else
         {
-            sizes.back() += remaining;
+            edges[static_cast<std::size_t>(n)] += remaining;
         }
 
-        return sizes;
+        edges[0] = origin;
+        for (std::size_t i = 1; i < edges.size(); ++i)
+            edges[i] = edges[i - 1] + std::max(0, edges[i]);
     }
 
-    std::vector<int> compute_track_offsets(const std::vector<int> &sizes, int origin)
+    native::rect cell_rect(const std::vector<int> &row_edges,
+                           const std::vector<int> &col_edges,
+                           int row,
+                           int column,
+                           int row_span,
+                           int column_span,
+                           int margin)
     {
-        std::vector<int> offsets(sizes.size(), origin);
-        int cur = origin;
-        for (std::size_t i = 0; i < sizes.size(); ++i)
-        {
-            offsets[i] = cur;
-            cur += std::max(0, sizes[i]);
-        }
-        return offsets;
-    }
-
-    native::rect compute_cell_rect(const native::rect &bounds,
-                                   const std::vector<native::grid_length> &row_defs,
-                                   const std::vector<native::grid_length> &col_defs,
-                                   int row,
-                                   int column,
-                                   int row_span,
-                                   int column_span,
-                                   int margin)
-    {
-        std::vector<native::grid_length> rows = row_defs;
-        std::vector<native::grid_length> cols = col_defs;
-
-        if (rows.empty())
-            rows.push_back(native::grid_length::star());
-        if (cols.empty())
-            cols.push_back(native::grid_length::star());
-
-        const int nr = static_cast<int>(rows.size());
-        const int nc = static_cast<int>(cols.size());
+        const int nr = static_cast<int>(row_edges.size()) - 1;
+        const int nc = static_cast<int>(col_edges.size()) - 1;
 
         const int r = std::max(0, std::min(row, nr - 1));
         const int c = std::max(0, std::min(column, nc - 1));
-        const int rs = std::max(1, row_span);
-        const int cs = std::max(1, column_span);
-        const int r2 = std::min(nr, r + rs) - 1;
-        const int c2 = std::min(nc, c + cs) - 1;
-
-        const std::vector<int> row_sizes = compute_track_sizes(rows, static_cast<int>(bounds.d.h));
-        const std::vector<int> col_sizes = compute_track_sizes(cols, static_cast<int>(bounds.d.w));
-        const std::vector<int> row_offsets = compute_track_offsets(row_sizes, bounds.p.y);
-        const std::vector<int> col_offsets = compute_track_offsets(col_sizes, bounds.p.x);
+        const int r2 = std::min(nr, r + std::max(1, row_span));
+        const int c2 = std::min(nc, c + std::max(1, column_span));
 
-        int x = col_offsets[static_cast<std::size_t>(c)];
-        int y = row_offsets[static_cast<std::size_t>(r)];
+        const int m = std::max(0, margin);
+        const int x = col_edges[static_cast<std::size_t>(c)] + m;
+        const int y = row_edges[static_cast<std::size_t>(r)] + m;
+        const int w = std::max(0, col_edges[static_cast<std::size_t>(c2)] - col_edges[static_cast<std::size_t>(c)] - (m * 2));
+        const int h = std::max(0, row_edges[static_cast<std::size_t>(r2)] - row_edges[static_cast<std::size_t>(r)] - (m * 2));
 
-        int w = 0;
-        for (int i = c; i <= c2; ++i)
-            w += col_sizes[static_cast<std::size_t>(i)];
+        return native::rect(clamp_coord(x), clamp_coord(y), clamp_dim(w), clamp_dim(h));
+    }
 
-        int h = 0;
-        for (int i = r; i <= r2; ++i)
-            h += row_sizes[static_cast<std::size_t>(i)];
+    bool same_rect(const native::rect &a, const native::rect &b)
+    {
+        return a.p.x == b.p.x && a.p.y == b.p.y && a.d.w == b.d.w && a.d.h == b.d.h;
+    }
 
-        const int m = std::max(0, margin);
-        x += m;
-        y += m;
-        w = std::max(0, w - (m * 2));
-        h = std::max(0, h - (m * 2));
+    void place(native::wnd *child, const native::rect &r)
+    {
+        if (!same_rect(child->bounds(), r))
+            child->set_bounds(r);
+    }
 
-        return native::rect(clamp_coord(x), clamp_coord(y), clamp_dim(w), clamp_dim(h));
+    bool has_auto(const std::vector<native::grid_length> &defs)
+    {
+        return std::any_of(defs.begin(), defs.end(), [](const native::grid_length &d) {
+            return d.type == native::grid_length::unit::automatic;
+        });
     }
 }
 
@@ -190,6 +194,19 @@ namespace native
         return l;
     }
 
+    grid_length grid_length::auto_()
+    {
+        grid_length l;
+        l.value = 0.0f;
+        l.type = unit::automatic;
+        return l;
+    }
+
+    size layout_manager::measure(const wnd *parent) const
+    {
+        return parent ? parent->dimensions() : size();
+    }
+
     grid_child_layout_def::grid_child_layout_def(std::unique_ptr<grid_layout_manager> child_layout,
                                                  int r,
                                                  int c,
@@ -280,13 +297,33 @@ namespace native
         return _children;
     }
 
+    size absolute_layout_manager::measure(const wnd *) const
+    {
+        int w = 0;
+        int h = 0;
+        for (auto *child : _children)
+        {
+            const rect b = child->bounds();
+            w = std::max(w, b.p.x + static_cast<int>(b.d.w));
+            h = std::max(h, b.p.y + static_cast<int>(b.d.h));
+        }
+        return size(clamp_dim(w), clamp_dim(h));
+    }
+
+    struct grid_layout_manager::child_index
+    {
+        detail::flat_map<wnd *, std::size_t> at;
+    };
+
     grid_layout_manager::grid_layout_manager()
+        : _index(std::make_unique<child_index>())
     {
         _rows.push_back(grid_length::star());
         _columns.push_back(grid_length::star());
     }
 
     grid_layout_manager::grid_layout_manager(int rows, int columns)
+        : _index(std::make_unique<child_index>())
     {
         const int rr = std::max(1, rows);
         const int cc = std::max(1, columns);
@@ -294,6 +331,8 @@ namespace native
         _columns.assign(static_cast<std::size_t>(cc), grid_length::star());
     }
 
+    grid_layout_manager::~grid_layout_manager() = default;
+
     grid_layout_manager &grid_layout_manager::add_row(grid_length length)
     {
         _rows.push_back(length);
@@ -321,22 +360,21 @@ namespace native
         ensure_track_count(_rows, r + rs);
         ensure_track_count(_columns, c + cs);
 
-        push_unique(_children, &child);
-
-        auto it = std::find_if(_placed_children.begin(),
-                               _placed_children.end(),
-                               [&](const placed_child &p) { return p.child == &child; });
-        if (it == _placed_children.end())
+        const std::size_t i = _index->at.find(&child);
+        if (i == _index->at.npos)
         {
+            _index->at.insert(&child, _placed_children.size());
             _placed_children.push_back({&child, r, c, rs, cs, margin});
+            _children.push_back(&child);
         }
         else
         {
-            it->row = r;
-            it->column = c;
-            it->row_span = rs;
-            it->column_span = cs;
-            it->margin = margin;
+            placed_child &p = _placed_children[_index->at.value(i)];
+            p.row = r;
+            p.column = c;
+            p.row_span = rs;
+            p.column_span = cs;
+            p.margin = margin;
         }
 
         return *this;
@@ -397,41 +435,45 @@ namespace native
         if (!parent)
             return;
 
-        std::vector<grid_length> row_defs = _rows;
-        std::vector<grid_length> col_defs = _columns;
-        if (row_defs.empty())
-            row_defs.push_back(grid_length::star());
-        if (col_defs.empty())
-            col_defs.push_back(grid_length::star());
+        // Track edges are computed once per pass; every cell is then a
+        // couple of lookups into them. Children are only measured when
+        // an auto track needs them, and then from their cached sizes.
+        _row_content.clear();
+        _column_content.clear();
+        if (has_auto(_rows) || has_auto(_columns))
+            measure_tracks(parent, _row_content, _column_content);
+
+        compute_track_edges(_rows, _row_content, static_cast<int>(bounds.d.h), bounds.p.y, _row_edges);
+        compute_track_edges(_columns, _column_content, static_cast<int>(bounds.d.w), bounds.p.x, _column_edges);
 
         for (const auto &placed : _placed_children)
         {
             if (!placed.child)
                 continue;
 
-            const rect r = compute_cell_rect(bounds,
-                                             row_defs,
-                                             col_defs,
-                                             placed.row,
-                                             placed.column,
-                                             placed.row_span,
-                                             placed.column_span,
-                                             placed.margin);
-            placed.child->set_bounds(r);
+            const rect r = cell_rect(_row_edges,
+                                     _column_edges,
+                                     placed.row,
+                                     placed.column,
+                                     placed.row_span,
+                                     placed.column_span,
+                                     placed.margin);
+
+            // A child that keeps its cell is not touched.
+            place(placed.child, r);
         }
 
         for (auto &nested : _nested_grids)
         {
             if (!nested.layout)
                 continue;
-            const rect r = compute_cell_rect(bounds,
-                                             row_defs,
-                                             col_defs,
-                                             nested.row,
-                                             nested.column,
-                                             nested.row_span,
-                                             nested.column_span,
-                                             nested.margin);
+            const rect r = cell_rect(_row_edges,
+                                     _column_edges,
+                                     nested.row,
+                                     nested.column,
+                                     nested.row_span,
+                                     nested.column_span,
+                                     nested.margin);
             nested.layout->relayout(parent, r);
         }
     }
@@ -464,12 +506,22 @@ namespace native
 
     void grid_layout_manager::remove_child(wnd *child)
     {
-        remove_ptr(_children, child);
-        _placed_children.erase(
-            std::remove_if(_placed_children.begin(),
-                           _placed_children.end(),
-                           [&](const placed_child &p) { return p.child == child; }),
-            _placed_children.end());
+        const std::size_t slot = _index->at.find(child);
+        if (slot != _index->at.npos)
+        {
+            // Cell order does not affect placement, so the last child
+            // fills the hole in both lists.
+            const std::size_t i = _index->at.value(slot);
+            _index->at.erase_at(slot);
+            if (i + 1 != _placed_children.size())
+            {
+                _placed_children[i] = _placed_children.back();
+                _children[i] = _children.back();
+                _index->at.insert(_children[i], i);
+            }
+            _placed_children.pop_back();
+            _children.pop_back();
+        }
 
         for (auto &nested : _nested_grids)
         {
@@ -482,4 +534,248 @@ namespace native
     {
         return _children;
     }
+
+    void grid_layout_manager::measure_tracks(const wnd *parent,
+                                             std::vector<int> &rows,
+                                             std::vector<int> &columns) const
+    {
+        rows.assign(_rows.size(), 0);
+        columns.assign(_columns.size(), 0);
+
+        const auto fit = [&](int r, int c, int rs, int cs, int margin, size d) {
+            const int m = std::max(0, margin) * 2;
+            if (rs == 1 && r >= 0 && r < static_cast<int>(rows.size()))
+                rows[static_cast<std::size_t>(r)] = std::max(rows[static_cast<std::size_t>(r)], static_cast<int>(d.h) + m);
+            if (cs == 1 && c >= 0 && c < static_cast<int>(columns.size()))
+                columns[static_cast<std::size_t>(c)] = std::max(columns[static_cast<std::size_t>(c)], static_cast<int>(d.w) + m);
+        };
+
+        for (const auto &placed : _placed_children)
+        {
+            if (placed.child)
+                fit(placed.row, placed.column, placed.row_span, placed.column_span, placed.margin,
+                    placed.child->desired_size());
+        }
+
+        for (const auto &nested : _nested_grids)
+        {
+            if (nested.layout)
+                fit(nested.row, nested.column, nested.row_span, nested.column_span, nested.margin,
+                    nested.layout->measure(parent));
+        }
+    }
+
+    size grid_layout_manager::measure(const wnd *parent) const
+    {
+        std::vector<int> rows;
+        std::vector<int> columns;
+        measure_tracks(parent, rows, columns);
+
+        const auto total = [](const std::vector<grid_length> &defs, const std::vector<int> &content) {
+            int sum = 0;
+            for (std::size_t i = 0; i < defs.size(); ++i)
+            {
+                if (defs[i].type == grid_length::unit::pixel)
+                    sum += static_cast<int>(std::lround(std::max(0.0f, defs[i].value)));
+                else
+                    sum += content[i];
+            }
+            return sum;
+        };
+
+        return size(clamp_dim(total(_columns, columns)), clamp_dim(total(_rows, rows)));
+    }
+
+    stack_layout_manager::stack_layout_manager(orientation o, int spacing)
+        : _orientation(o),
+          _spacing(std::max(0, spacing))
+    {
+    }
+
+    stack_layout_manager &stack_layout_manager::operator<<(wnd &child)
+    {
+        return add(child);
+    }
+
+    stack_layout_manager &stack_layout_manager::add(wnd &child)
+    {
+        add_child(&child);
+        return *this;
+    }
+
+    void stack_layout_manager::relayout(wnd *parent, const rect &bounds)
+    {
+        if (!parent)
+            return;
+
+        const bool vertical = _orientation == orientation::vertical;
+        int at = vertical ? bounds.p.y : bounds.p.x;
+        for (auto *child : _children)
+        {
+            const size d = child->desired_size();
+            if (vertical)
+            {
+                place(child, rect(bounds.p.x, clamp_coord(at), bounds.d.w, d.h));
+                at += d.h + _spacing;
+            }
+            else
+            {
+                place(child, rect(clamp_coord(at), bounds.p.y, d.w, bounds.d.h));
+                at += d.w + _spacing;
+            }
+        }
+    }
+
+    void stack_layout_manager::add_child(wnd *child)
+    {
+        push_unique(_children, child);
+    }
+
+    void stack_layout_manager::remove_child(wnd *child)
+    {
+        remove_ptr(_children, child);
+    }
+
+    const std::vector<wnd *> &stack_layout_manager::children() const
+    {
+        return _children;
+    }
+
+    size stack_layout_manager::measure(const wnd *) const
+    {
+        const bool vertical = _orientation == orientation::vertical;
+        int along = 0;
+        int across = 0;
+        for (auto *child : _children)
+        {
+            const size d = child->desired_size();
+            along += vertical ? d.h : d.w;
+            across = std::max(across, static_cast<int>(vertical ? d.w : d.h));
+        }
+        if (!_children.empty())
+            along += _spacing * (static_cast<int>(_children.size()) - 1);
+
+        return vertical ? size(clamp_dim(across), clamp_dim(along))
+                        : size(clamp_dim(along), clamp_dim(across));
+    }
+
+    dock_layout_manager &dock_layout_manager::add(wnd &child, dock_side side)
+    {
+        const auto it = std::find(_children.begin(), _children.end(), &child);
+        if (it != _children.end())
+        {
+            _sides[static_cast<std::size_t>(it - _children.begin())] = side;
+            return *this;
+        }
+
+        _children.push_back(&child);
+        _sides.push_back(side);
+        return *this;
+    }
+
+    void dock_layout_manager::relayout(wnd *parent, const rect &bounds)
+    {
+        if (!parent)
+            return;
+
+        int x = bounds.p.x;
+        int y = bounds.p.y;
+        int w = bounds.d.w;
+        int h = bounds.d.h;
+
+        for (std::size_t i = 0; i < _children.size(); ++i)
+        {
+            wnd *child = _children[i];
+            const size d = child->desired_size();
+            switch (_sides[i])
+            {
+            case dock_side::left:
+            {
+                const int cw = std::min(w, static_cast<int>(d.w));
+                place(child, rect(clamp_coord(x), clamp_coord(y), clamp_dim(cw), clamp_dim(h)));
+                x += cw;
+                w -= cw;
+                break;
+            }
+            case dock_side::right:
+            {
+                const int cw = std::min(w, static_cast<int>(d.w));
+                place(child, rect(clamp_coord(x + w - cw), clamp_coord(y), clamp_dim(cw), clamp_dim(h)));
+                w -= cw;
+                break;
+            }
+            case dock_side::top:
+            {
+                const int ch = std::min(h, static_cast<int>(d.h));
+                place(child, rect(clamp_coord(x), clamp_coord(y), clamp_dim(w), clamp_dim(ch)));
+                y += ch;
+                h -= ch;
+                break;
+            }
+            case dock_side::bottom:
+            {
+                const int ch = std::min(h, static_cast<int>(d.h));
+                place(child, rect(clamp_coord(x), clamp_coord(y + h - ch), clamp_dim(w), clamp_dim(ch)));
+                h -= ch;
+                break;
+            }
+            case dock_side::fill:
+                place(child, rect(clamp_coord(x), clamp_coord(y), clamp_dim(w), clamp_dim(h)));
+                break;
+            }
+        }
+    }
+
+    void dock_layout_manager::add_child(wnd *child)
+    {
+        if (child && std::find(_children.begin(), _children.end(), child) == _children.end())
+            add(*child, dock_side::fill);
+    }
+
+    void dock_layout_manager::remove_child(wnd *child)
+    {
+        const auto it = std::find(_children.begin(), _children.end(), child);
+        if (it == _children.end())
+            return;
+
+        _sides.erase(_sides.begin() + (it - _children.begin()));
+        _children.erase(it);
+    }
+
+    const std::vector<wnd *> &dock_layout_manager::children() const
+    {
+        return _children;
+    }
+
+    size dock_layout_manager::measure(const wnd *) const
+    {
+        // Edge children add up along their edge; the widest or tallest
+        // run across them sets the other dimension.
+        int used_w = 0;
+        int used_h = 0;
+        int w = 0;
+        int h = 0;
+        for (std::size_t i = 0; i < _children.size(); ++i)
+        {
+            const size d = _children[i]->desired_size();
+            switch (_sides[i])
+            {
+            case dock_side::left:
+            case dock_side::right:
+                h = std::max(h, used_h + d.h);
+                used_w += d.w;
+                break;
+            case dock_side::top:
+            case dock_side::bottom:
+                w = std::max(w, used_w + d.w);
+                used_h += d.h;
+                break;
+            case dock_side::fill:
+                w = std::max(w, used_w + d.w);
+                h = std::max(h, used_h + d.h);
+                break;
+            }
+        }
+        return size(clamp_dim(std::max(w, used_w)), clamp_dim(std::max(h, used_h)));
+    }
 }
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <utility>
+
+#include <native.h>
+
+#include "layout_queue.h"
+
+namespace native
+{
+namespace detail
+{
+    layout_queue &layouts()
+    {
+        static layout_queue instance;
+        return instance;
+    }
+
+    static int depth_of(const wnd *w)
+    {
+        int depth = 0;
+        for (const wnd *p = w->parent(); p; p = p->parent())
+            ++depth;
+        return depth;
+    }
+
+    static bool same(const rect &a, const rect &b)
+    {
+        return a.p.x == b.p.x && a.p.y == b.p.y && a.d.w == b.d.w && a.d.h == b.d.h;
+    }
+
+    static void sort_top_down(std::vector<wnd *> &v)
+    {
+        std::vector<std::pair<int, wnd *>> keyed;
+        keyed.reserve(v.size());
+        for (auto *w : v)
+            keyed.emplace_back(depth_of(w), w);
+
+        std::stable_sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        });
+
+        for (std::size_t i = 0; i < v.size(); ++i)
+            v[i] = keyed[i].second;
+    }
+
+    void layout_queue::begin()
+    {
+        ++_depth;
+    }
+
+    bool layout_queue::deferring() const
+    {
+        return _depth > 0;
+    }
+
+    layout_queue::pending *layout_queue::find(wnd *w)
+    {
+        const std::size_t i = _index.find(w);
+        return i != _index.npos ? &_pending[_index.value(i)] : nullptr;
+    }
+
+    layout_queue::pending &layout_queue::entry(wnd *w)
+    {
+        if (auto *p = find(w))
+            return *p;
+
+        _index.insert(w, _pending.size());
+        _pending.push_back({w, nullptr, rect(), false});
+        return _pending.back();
+    }
+
+    void layout_queue::relayout(wnd *w)
+    {
+        if (w)
+            entry(w).relayout = true;
+    }
+
+    void layout_queue::move(wnd *w, const rect &from, apply_fn apply, flush_fn flush)
+    {
+        if (!w)
+            return;
+
+        auto &p = entry(w);
+        if (!p.apply)
+            p.from = from;
+        p.apply = apply;
+        _flush = flush;
+    }
+
+    void layout_queue::cancel(const wnd *w)
+    {
+        const std::size_t i = _index.find(w);
+        if (i == _index.npos)
+            return;
+
+        _pending[_index.value(i)].w = nullptr;
+        _index.erase_at(i);
+    }
+
+    void layout_queue::end()
+    {
+        if (_depth == 0 || --_depth > 0)
+            return;
+
+        // The update stays open while layouts run, so the children they
+        // move are queued rather than laid out on the spot. Ancestors
+        // run first; a window queued again by one of them still runs
+        // only once.
+        ++_depth;
+        std::vector<wnd *> batch;
+        for (;;)
+        {
+            batch.clear();
+            for (const auto &p : _pending)
+            {
+                if (p.w && p.relayout)
+                    batch.push_back(p.w);
+            }
+            if (batch.empty())
+                break;
+
+            sort_top_down(batch);
+            for (auto *w : batch)
+            {
+                auto *p = find(w);
+                if (!p || !p->relayout)
+                    continue;
+
+                p->relayout = false;
+                if (auto *l = w->layout())
+                {
+                    const size d = w->dimensions();
+                    l->relayout(w, rect(0, 0, d.w, d.h));
+                }
+            }
+        }
+        --_depth;
+
+        // Geometry goes out last, with the final bounds of every window
+        // that did not end up where it started.
+        std::vector<wnd *> moved;
+        std::vector<apply_fn> apply;
+        for (const auto &p : _pending)
+        {
+            if (p.w && p.apply && !same(p.w->bounds(), p.from))
+                moved.push_back(p.w);
+        }
+        sort_top_down(moved);
+        for (auto *w : moved)
+            apply.push_back(find(w)->apply);
+
+        flush_fn flush = _flush;
+        _pending.clear();
+        _index.clear();
+        _flush = nullptr;
+
+        for (std::size_t i = 0; i < moved.size(); ++i)
+            apply[i](moved[i]);
+        if (flush && !moved.empty())
+            flush();
+    }
+}
+}
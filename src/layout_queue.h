@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <native.h>
+#include <bindings.h>
+
+namespace native
+{
+namespace detail
+{
+    // Layout transactions behind app::begin_update()/end_update(). While
+    // an update is open, wnd::relayout() and the backends' geometry
+    // setters only queue work here. The outermost end() runs every queued
+    // layout once, parents before children, then pushes each moved
+    // window's geometry to the toolkit and flushes the toolkit once.
+    class layout_queue
+    {
+    public:
+        // Pushes w's current bounds to the toolkit, without flushing.
+        using apply_fn = void (*)(wnd *w);
+        using flush_fn = void (*)();
+
+        void begin();
+        void end();
+
+        bool deferring() const;
+
+        // Runs w's layout when the update closes.
+        void relayout(wnd *w);
+
+        // Pushes w's geometry with apply when the update closes, unless
+        // w is back at from, its bounds before the first deferred move.
+        // flush runs once after every window has been applied.
+        void move(wnd *w, const rect &from, apply_fn apply, flush_fn flush);
+
+        void cancel(const wnd *w);
+
+    private:
+        struct pending
+        {
+            wnd *w; // nullptr once cancelled
+            apply_fn apply;
+            rect from;
+            bool relayout;
+        };
+
+        pending &entry(wnd *w);
+        pending *find(wnd *w);
+
+        int _depth = 0;
+        std::vector<pending> _pending;
+        flat_map<const wnd *, std::size_t> _index;
+        flush_fn _flush = nullptr;
+    };
+
+    layout_queue &layouts();
+}
+}
@@ -0,0 +1,497 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include <native.h>
+
+namespace native
+{
+    static constexpr int wheel_rows = 3;
+
+    list_view::list_view(wnd &w, const rect &bounds)
+        : _w(w),
+          _bounds(bounds)
+    {
+        _block_top.push_back(0);
+
+        // Runs after every handler connected later, so the rows land on
+        // top of them.
+        _paint_slot = _w.on_wnd_paint.connect([this](wnd_paint_event e) {
+            paint(e.g);
+            return false;
+        });
+
+        _click_slot = _w.on_mouse_click.connect([this](mouse_event e) {
+            if (e.button != mouse_button::left || e.action != mouse_action::press)
+                return false;
+            if (!body().contains(e.position))
+                return false;
+
+            const std::size_t row = row_at(e.position);
+            if (row != npos)
+                select(row);
+            return true;
+        });
+
+        _wheel_slot = _w.on_mouse_wheel.connect([this](mouse_wheel_event e) {
+            if (!_bounds.contains(e.position))
+                return false;
+
+            const int step = wheel_rows * _row_height;
+            if (e.direction == wheel_direction::horizontal)
+                scroll_horizontal(e.delta * step);
+            else
+                scroll_to(_offset - static_cast<int64_t>(e.delta) * step);
+            return true;
+        });
+    }
+
+    list_view::~list_view()
+    {
+        _w.on_wnd_paint.disconnect(_paint_slot);
+        _w.on_mouse_click.disconnect(_click_slot);
+        _w.on_mouse_wheel.disconnect(_wheel_slot);
+    }
+
+    list_view &list_view::set_source(count_fn count, text_fn text)
+    {
+        _count = std::move(count);
+        _text = std::move(text);
+        return reload();
+    }
+
+    list_view &list_view::set_row_height(dim h)
+    {
+        _row_height = std::max<dim>(1, h);
+        _height = nullptr;
+        return reload();
+    }
+
+    list_view &list_view::set_row_heights(height_fn height)
+    {
+        _height = std::move(height);
+        return reload();
+    }
+
+    list_view &list_view::reload()
+    {
+        return reload_from(0);
+    }
+
+    list_view &list_view::reload_from(std::size_t first)
+    {
+        // Block b of the index only sums rows before b * block_rows.
+        _block_top.resize(std::min(_block_top.size(), first / block_rows + 1));
+        _index_complete = false;
+
+        if (_selected != npos && _selected >= count())
+            _selected = npos;
+
+        const int64_t max_offset = std::max<int64_t>(0, content_height() - body().d.h);
+        const int64_t offset = std::max<int64_t>(0, std::min(_offset, max_offset));
+        if (offset != _offset || first == 0)
+        {
+            _offset = offset;
+            _w.invalidate(_bounds);
+            return *this;
+        }
+
+        // Rows above first are unchanged.
+        const rect b = body();
+        const int64_t top = std::max<int64_t>(0, row_top(first) - _offset);
+        if (top < b.d.h)
+            _w.invalidate(rect(b.p.x, static_cast<coord>(b.p.y + top), b.d.w, static_cast<dim>(b.d.h - top)));
+        return *this;
+    }
+
+    list_view &list_view::set_bounds(const rect &r)
+    {
+        _w.invalidate(_bounds);
+        _bounds = r;
+        _w.invalidate(_bounds);
+        return *this;
+    }
+
+    rect list_view::bounds() const
+    {
+        return _bounds;
+    }
+
+    list_view &list_view::scroll_to(int64_t y)
+    {
+        const int64_t max_offset = std::max<int64_t>(0, content_height() - body().d.h);
+        y = std::max<int64_t>(0, std::min(y, max_offset));
+        if (y == _offset)
+            return *this;
+
+        const int64_t dy = _offset - y;
+        _offset = y;
+        scroll_body(body(), 0, static_cast<int>(std::max<int64_t>(-32768, std::min<int64_t>(32767, dy))));
+        return *this;
+    }
+
+    int64_t list_view::scroll_offset() const
+    {
+        return _offset;
+    }
+
+    list_view &list_view::ensure_visible(std::size_t row)
+    {
+        if (row >= count())
+            return *this;
+
+        const int64_t top = row_top(row);
+        const int64_t bottom = top + height_of(row);
+        const int64_t h = body().d.h;
+
+        if (top < _offset)
+            scroll_to(top);
+        else if (bottom > _offset + h)
+            scroll_to(bottom - h);
+        return *this;
+    }
+
+    std::size_t list_view::row_at(point p)
+    {
+        const rect b = body();
+        if (!b.contains(p))
+            return npos;
+        return row_at_offset(_offset + (p.y - b.p.y));
+    }
+
+    list_view &list_view::select(std::size_t row)
+    {
+        if (row == _selected || (row != npos && row >= count()))
+            return *this;
+
+        invalidate_row(_selected);
+        _selected = row;
+        invalidate_row(_selected);
+        on_select.emit(row);
+        return *this;
+    }
+
+    std::size_t list_view::selected() const
+    {
+        return _selected;
+    }
+
+    int64_t list_view::content_height()
+    {
+        const std::size_t n = count();
+        if (!_height)
+            return static_cast<int64_t>(n) * _row_height;
+
+        // The source shrank without a reload(); blocks past its end sum
+        // rows that are gone.
+        if ((_block_top.size() - 1) * block_rows > n)
+        {
+            _block_top.resize(n / block_rows + 1);
+            _index_complete = false;
+        }
+
+        if (_block_top.size() == 1)
+            grow_index();
+        if (_index_complete)
+            return _block_top.back();
+
+        // Rows past the index are assumed to be as tall as the average
+        // row so far.
+        const std::size_t indexed = (_block_top.size() - 1) * block_rows;
+        const int64_t known = _block_top.back();
+        return known + static_cast<int64_t>(n - indexed) * known / static_cast<int64_t>(indexed);
+    }
+
+    rect list_view::body() const
+    {
+        return _bounds;
+    }
+
+    void list_view::paint_row(gpx &g, std::size_t row, const rect &r, const control_paint::state &st)
+    {
+        control_paint(g).draw_list_item(r, _text ? _text(row) : std::string(), st);
+    }
+
+    void list_view::scroll_horizontal(int)
+    {
+    }
+
+    void list_view::paint(gpx &g)
+    {
+        const rect b = body();
+        const rect clip = g.clip();
+        const rect area = clip.intersect(b);
+        if (area.d.w == 0 || area.d.h == 0)
+            return;
+
+        g.set_clip(area);
+
+        // Only rows that intersect the painted area are asked for.
+        const std::size_t n = count();
+        const int64_t bottom = _offset + (area.p.y + area.d.h - b.p.y);
+        std::size_t row = row_at_offset(_offset + (area.p.y - b.p.y));
+        int64_t top = row != npos ? row_top(row) : 0;
+
+        for (; row != npos && row < n && top < bottom; ++row)
+        {
+            const dim h = height_of(row);
+            const rect r(b.p.x, static_cast<coord>(b.p.y + (top - _offset)), b.d.w, h);
+
+            control_paint::state st;
+            st.selected = row == _selected;
+            paint_row(g, row, r, st);
+            top += h;
+        }
+
+        // Below the last row.
+        const int64_t end = row == npos ? 0 : top;
+        const int gap = static_cast<int>(std::max<int64_t>(b.p.y, b.p.y + (end - _offset)));
+        if (gap < area.p.y + area.d.h)
+        {
+            const rgba ink = g.ink();
+            g.set_ink(control_paint::native_palette().menu_popup_bg)
+                .draw_rect(rect(area.p.x, static_cast<coord>(std::max<int>(gap, area.p.y)),
+                                area.d.w, static_cast<dim>(area.p.y + area.d.h - std::max<int>(gap, area.p.y))),
+                           true);
+            g.set_ink(ink);
+        }
+
+        g.set_clip(clip);
+    }
+
+    void list_view::scroll_body(const rect &area, int dx, int dy)
+    {
+        if (dx == 0 && dy == 0)
+            return;
+
+        // A jump of a whole view or more has nothing to keep.
+        if (std::abs(dx) >= area.d.w || std::abs(dy) >= area.d.h)
+        {
+            _w.invalidate(area);
+            return;
+        }
+        _w.scroll(area, static_cast<coord>(dx), static_cast<coord>(dy));
+    }
+
+    std::size_t list_view::count() const
+    {
+        return _count ? _count() : 0;
+    }
+
+    dim list_view::height_of(std::size_t row) const
+    {
+        return _height ? std::max<dim>(1, _height(row)) : _row_height;
+    }
+
+    bool list_view::grow_index()
+    {
+        if (_index_complete)
+            return false;
+
+        const std::size_t n = count();
+        const std::size_t first = (_block_top.size() - 1) * block_rows;
+        const std::size_t last = std::min(n, first + block_rows);
+
+        int64_t top = _block_top.back();
+        for (std::size_t r = first; r < last; ++r)
+            top += height_of(r);
+
+        _block_top.push_back(top);
+        _index_complete = last == n;
+        return true;
+    }
+
+    int64_t list_view::row_top(std::size_t row)
+    {
+        if (!_height)
+            return static_cast<int64_t>(row) * _row_height;
+
+        const std::size_t block = row / block_rows;
+        while (_block_top.size() <= block + 1 && grow_index())
+        {
+        }
+        if (block >= _block_top.size())
+            return _block_top.back();
+
+        int64_t top = _block_top[block];
+        for (std::size_t r = block * block_rows; r < row; ++r)
+            top += height_of(r);
+        return top;
+    }
+
+    std::size_t list_view::row_at_offset(int64_t y)
+    {
+        const std::size_t n = count();
+        if (y < 0 || n == 0)
+            return npos;
+
+        if (!_height)
+        {
+            const std::size_t row = static_cast<std::size_t>(y / _row_height);
+            return row < n ? row : npos;
+        }
+
+        while (!_index_complete && _block_top.back() <= y)
+            grow_index();
+
+        // Entries past the first are block ends; the last one of a
+        // complete index is the total height.
+        const auto it = std::upper_bound(_block_top.begin(), _block_top.end(), y);
+        if (it == _block_top.end())
+            return npos;
+
+        const std::size_t block = static_cast<std::size_t>(it - _block_top.begin()) - 1;
+        int64_t top = _block_top[block];
+        for (std::size_t r = block * block_rows; r < n; ++r)
+        {
+            top += height_of(r);
+            if (top > y)
+                return r;
+        }
+        return npos;
+    }
+
+    void list_view::invalidate_row(std::size_t row)
+    {
+        if (row == npos || row >= count())
+            return;
+
+        const rect b = body();
+        const int64_t top = row_top(row) - _offset;
+        if (top >= b.d.h || top + height_of(row) <= 0)
+            return;
+
+        const int y = b.p.y + static_cast<int>(top);
+        const rect r = b.intersect(rect(b.p.x, static_cast<coord>(std::max<int>(y, -32768)), b.d.w, height_of(row)));
+        if (r.d.w > 0 && r.d.h > 0)
+            _w.invalidate(r);
+    }
+
+    table_view::table_view(wnd &w, const rect &bounds)
+        : list_view(w, bounds)
+    {
+        _column_left.push_back(0);
+    }
+
+    table_view &table_view::set_columns(std::vector<column> columns)
+    {
+        _columns = std::move(columns);
+        _column_left.assign(1, 0);
+        for (const auto &c : _columns)
+            _column_left.push_back(_column_left.back() + c.width);
+
+        _column_offset = std::max(0, std::min(_column_offset, total_width() - static_cast<int>(body().d.w)));
+        _w.invalidate(_bounds);
+        return *this;
+    }
+
+    table_view &table_view::set_source(count_fn count, cell_fn cell)
+    {
+        _cell = std::move(cell);
+        list_view::set_source(std::move(count), nullptr);
+        return *this;
+    }
+
+    table_view &table_view::set_header_height(dim h)
+    {
+        _header_height = h;
+        reload();
+        return *this;
+    }
+
+    table_view &table_view::scroll_columns_to(int x)
+    {
+        const int max_offset = std::max(0, total_width() - static_cast<int>(body().d.w));
+        x = std::max(0, std::min(x, max_offset));
+        if (x == _column_offset)
+            return *this;
+
+        const int dx = _column_offset - x;
+        _column_offset = x;
+        scroll_body(_bounds, dx, 0);
+        return *this;
+    }
+
+    int table_view::column_offset() const
+    {
+        return _column_offset;
+    }
+
+    rect table_view::body() const
+    {
+        const dim h = std::min(_header_height, _bounds.d.h);
+        return rect(_bounds.p.x, static_cast<coord>(_bounds.p.y + h), _bounds.d.w, static_cast<dim>(_bounds.d.h - h));
+    }
+
+    void table_view::paint_row(gpx &g, std::size_t row, const rect &r, const control_paint::state &st)
+    {
+        control_paint cp(g);
+        const int right = _column_offset + r.d.w;
+        for (std::size_t c = column_at(_column_offset); c < _columns.size() && _column_left[c] < right; ++c)
+        {
+            const rect cell(static_cast<coord>(r.p.x + _column_left[c] - _column_offset), r.p.y,
+                            _columns[c].width, r.d.h);
+            cp.draw_list_item(cell, _cell ? _cell(row, c) : std::string(), st);
+        }
+
+        // Past the last column.
+        const int end = r.p.x + total_width() - _column_offset;
+        if (end < r.p.x + r.d.w)
+        {
+            const int x = std::max<int>(end, r.p.x);
+            cp.draw_list_item(rect(static_cast<coord>(x), r.p.y, static_cast<dim>(r.p.x + r.d.w - x), r.d.h),
+                              std::string(), st);
+        }
+    }
+
+    void table_view::scroll_horizontal(int dx)
+    {
+        scroll_columns_to(_column_offset + dx);
+    }
+
+    void table_view::paint(gpx &g)
+    {
+        const rect clip = g.clip();
+        const rect header(_bounds.p.x, _bounds.p.y, _bounds.d.w, std::min(_header_height, _bounds.d.h));
+        const rect area = clip.intersect(header);
+        if (area.d.w > 0 && area.d.h > 0)
+        {
+            g.set_clip(area);
+            control_paint cp(g);
+            const int left = _column_offset + (area.p.x - header.p.x);
+            const int right = left + area.d.w;
+            for (std::size_t c = column_at(left); c < _columns.size() && _column_left[c] < right; ++c)
+            {
+                cp.draw_button(rect(static_cast<coord>(header.p.x + _column_left[c] - _column_offset), header.p.y,
+                                    _columns[c].width, header.d.h),
+                               _columns[c].title);
+            }
+
+            const int end = header.p.x + total_width() - _column_offset;
+            if (end < area.p.x + area.d.w)
+            {
+                const int x = std::max<int>(end, area.p.x);
+                cp.draw_button_face(rect(static_cast<coord>(x), header.p.y,
+                                         static_cast<dim>(area.p.x + area.d.w - x), header.d.h),
+                                    control_paint::state{});
+            }
+            g.set_clip(clip);
+        }
+
+        list_view::paint(g);
+    }
+
+    std::size_t table_view::column_at(int x) const
+    {
+        // _column_left is sorted, so the first visible column is found by
+        // bisection however many columns there are.
+        const auto it = std::upper_bound(_column_left.begin(), _column_left.end(), x);
+        if (it == _column_left.begin())
+            return 0;
+        return static_cast<std::size_t>(it - _column_left.begin()) - 1;
+    }
+
+    int table_view::total_width() const
+    {
+        return _column_left.back();
+    }
+}
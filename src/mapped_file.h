@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace native
+{
+namespace detail
+{
+    // Read-only memory mapping of a whole file. Mapping does not read
+    // the file; pages are brought in as they are touched. Only
+    // platforms/posix implements it, for the backends that build
+    // text_view.
+    class mapped_file
+    {
+    public:
+        mapped_file() = default;
+        ~mapped_file();
+
+        mapped_file(const mapped_file &) = delete;
+        mapped_file &operator=(const mapped_file &) = delete;
+
+        bool open(const std::string &path);
+        void close();
+        bool is_open() const { return _file != invalid; }
+
+        // Size of the file now. It differs from size() once the file has
+        // been written to since it was last mapped.
+        uint64_t current_size() const;
+
+        // Maps the file again at its current size. Pointers from data()
+        // are invalid afterwards.
+        bool remap();
+
+        const char *data() const { return _data; }
+        uint64_t size() const { return _size; }
+
+        // Copies up to n bytes at offset from the file itself, not the
+        // mapping, so a file truncated since it was mapped gives a short
+        // read instead of a fault. Returns the number of bytes copied.
+        std::size_t read(uint64_t offset, char *out, std::size_t n) const;
+
+    private:
+        static constexpr intptr_t invalid = -1;
+
+        void unmap();
+
+        intptr_t _file = invalid; // fd
+        const char *_data = nullptr;
+        uint64_t _size = 0;
+    };
+}
+}
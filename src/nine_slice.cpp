@@ -0,0 +1,37 @@
+#include <algorithm>
+
+#include <native.h>
+
+#include "nine_slice.h"
+
+namespace native
+{
+    gpx &gpx::draw_img_nine_slice(const img &src, const rect &center, const rect &dst)
+    {
+        const rect area = clip().intersect(dst);
+        if (area.d.w == 0 || area.d.h == 0 || src.w() <= 0 || src.h() <= 0)
+            return *this;
+
+        // Only the visible part is scaled, so it goes out in one blit
+        // even to painters that do not clip draw_img().
+        img part(area.d.w, area.d.h);
+        part.create_gpx()->draw_img_nine_slice(
+            src, center,
+            rect(static_cast<coord>(dst.p.x - area.p.x), static_cast<coord>(dst.p.y - area.p.y), dst.d.w, dst.d.h));
+        return draw_img(part, area.p);
+    }
+
+namespace detail
+{
+    nine_slice_axis::nine_slice_axis(int size_, int head_, int tail_, int n_)
+        : size(size_), n(n_), head(head_), tail(tail_), middle(size_ - head_ - tail_)
+    {
+        if (head + tail >= n)
+        {
+            head = head + tail > 0 ? n * head / (head + tail) : n;
+            tail = n - head;
+            middle = 0;
+        }
+    }
+}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+
+#include <native.h>
+
+namespace native
+{
+namespace detail
+{
+    // One axis of a nine-slice drawn n pixels long from a source size
+    // pixels long. The first head destination pixels copy the first
+    // head source ones, the last tail copy the last tail, and the ones
+    // between stretch what is left. When n is less than both ends, they
+    // share it in proportion and nothing is left to stretch.
+    struct nine_slice_axis
+    {
+        nine_slice_axis(int size, int head, int tail, int n);
+
+        // Source pixel for destination pixel i.
+        int at(int i) const
+        {
+            if (i < head)
+                return i;
+            if (i >= n - tail)
+                return size - (n - i);
+            return middle > 0 ? head + (2 * (i - head) + 1) * middle / (2 * (n - head - tail))
+                              : std::min(head, size - 1);
+        }
+
+        int size;
+        int n;
+        int head;   // Destination pixels copied from the start.
+        int tail;   // Destination pixels copied from the end.
+        int middle; // Source pixels stretched between them.
+    };
+}
+}
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cmath>
+
+#include <native.h>
+
+namespace native
+{
+    static constexpr float pi = 3.14159265358979f;
+
+    // Segments for a curve whose control points have a largest second
+    // difference of dd, by Wang's formula: degree 2 needs dd / 4,
+    // degree 3 needs 3 * dd / 4, against the tolerance.
+    static int segments_for(float dd, float factor)
+    {
+        const float n = std::ceil(std::sqrt(factor * dd / path::tolerance));
+        return std::max(1, std::min(1024, static_cast<int>(n)));
+    }
+
+    path &path::move_to(float x, float y)
+    {
+        _contours.push_back(contour{_vertices.size(), 0, false});
+        _open = true;
+        add(x, y);
+        return *this;
+    }
+
+    path &path::line_to(float x, float y)
+    {
+        if (!_open)
+            return move_to(x, y);
+        add(x, y);
+        return *this;
+    }
+
+    path &path::quad_to(float cx, float cy, float x, float y)
+    {
+        if (!_open)
+            move_to(cx, cy);
+
+        const vertex p0 = _vertices.back();
+        const float ddx = p0.x - 2 * cx + x;
+        const float ddy = p0.y - 2 * cy + y;
+        const int n = segments_for(std::hypot(ddx, ddy), 0.25f);
+
+        for (int i = 1; i <= n; ++i)
+        {
+            const float t = static_cast<float>(i) / n;
+            const float u = 1 - t;
+            add(u * u * p0.x + 2 * u * t * cx + t * t * x,
+                u * u * p0.y + 2 * u * t * cy + t * t * y);
+        }
+        return *this;
+    }
+
+    path &path::cubic_to(float c1x, float c1y, float c2x, float c2y, float x, float y)
+    {
+        if (!_open)
+            move_to(c1x, c1y);
+
+        const vertex p0 = _vertices.back();
+        const float dd = std::max(std::hypot(p0.x - 2 * c1x + c2x, p0.y - 2 * c1y + c2y),
+                                  std::hypot(c1x - 2 * c2x + x, c1y - 2 * c2y + y));
+        const int n = segments_for(dd, 0.75f);
+
+        for (int i = 1; i <= n; ++i)
+        {
+            const float t = static_cast<float>(i) / n;
+            const float u = 1 - t;
+            const float a = u * u * u;
+            const float b = 3 * u * u * t;
+            const float c = 3 * u * t * t;
+            const float d = t * t * t;
+            add(a * p0.x + b * c1x + c * c2x + d * x,
+                a * p0.y + b * c1y + c * c2y + d * y);
+        }
+        return *this;
+    }
+
+    path &path::arc(float cx, float cy, float radius, float start, float sweep)
+    {
+        radius = std::abs(radius);
+        const float sx = cx + radius * std::cos(start);
+        const float sy = cy + radius * std::sin(start);
+        line_to(sx, sy);
+
+        // A chord of angle a strays r * (1 - cos(a / 2)) from the circle.
+        const float step = radius > tolerance ? 2 * std::acos(1 - tolerance / radius) : pi / 2;
+        const int n = std::max(1, std::min(1024, static_cast<int>(std::ceil(std::abs(sweep) / step))));
+
+        for (int i = 1; i <= n; ++i)
+        {
+            const float a = start + sweep * i / n;
+            add(cx + radius * std::cos(a), cy + radius * std::sin(a));
+        }
+        return *this;
+    }
+
+    path &path::close()
+    {
+        if (_open)
+            _contours.back().closed = true;
+        _open = false;
+        return *this;
+    }
+
+    path &path::clear()
+    {
+        _vertices.clear();
+        _contours.clear();
+        _open = false;
+        return *this;
+    }
+
+    bool path::empty() const
+    {
+        return _vertices.empty();
+    }
+
+    const std::vector<path::vertex> &path::vertices() const
+    {
+        return _vertices;
+    }
+
+    const std::vector<path::contour> &path::contours() const
+    {
+        return _contours;
+    }
+
+    void path::add(float x, float y)
+    {
+        contour &c = _contours.back();
+        if (c.count > 0)
+        {
+            const vertex &last = _vertices.back();
+            if (last.x == x && last.y == y)
+                return;
+        }
+        _vertices.push_back(vertex{x, y});
+        ++c.count;
+    }
+
+    gpx &gpx::fill_path(const path &p, fill_rule rule)
+    {
+        struct edge
+        {
+            float x0, y0, x1, y1;
+            int dir;
+        };
+
+        // Every contour is filled as if closed.
+        std::vector<edge> edges;
+        float top = HUGE_VALF, bottom = -HUGE_VALF;
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            for (std::size_t i = 0; i < c.count && c.count > 1; ++i)
+            {
+                const path::vertex &a = v[c.first + i];
+                const path::vertex &b = v[c.first + (i + 1) % c.count];
+                if (a.y == b.y)
+                    continue;
+                edges.push_back(a.y < b.y ? edge{a.x, a.y, b.x, b.y, 1} : edge{b.x, b.y, a.x, a.y, -1});
+                top = std::min(top, edges.back().y0);
+                bottom = std::max(bottom, edges.back().y1);
+            }
+        }
+        if (edges.empty())
+            return *this;
+
+        const rect area = clip();
+        const int y0 = std::max<int>(area.p.y, static_cast<int>(std::floor(top)));
+        const int y1 = std::min<int>(area.p.y + area.d.h, static_cast<int>(std::ceil(bottom)));
+
+        // Whole pixels whose centres are inside, one span at a time.
+        std::vector<std::pair<float, int>> xs;
+        for (int y = y0; y < y1; ++y)
+        {
+            const float sy = y + 0.5f;
+            xs.clear();
+            for (const edge &e : edges)
+            {
+                if (sy < e.y0 || sy >= e.y1)
+                    continue;
+                xs.emplace_back(e.x0 + (sy - e.y0) * (e.x1 - e.x0) / (e.y1 - e.y0), e.dir);
+            }
+            std::sort(xs.begin(), xs.end());
+
+            int winding = 0;
+            for (std::size_t i = 0; i + 1 < xs.size(); ++i)
+            {
+                winding += xs[i].second;
+                const bool inside = rule == fill_rule::nonzero ? winding != 0 : (winding & 1) != 0;
+                if (!inside)
+                    continue;
+
+                const int xa = std::max<int>(area.p.x, static_cast<int>(std::ceil(xs[i].first - 0.5f)));
+                const int xb = std::min<int>(area.p.x + area.d.w, static_cast<int>(std::ceil(xs[i + 1].first - 0.5f)));
+                if (xa < xb)
+                    draw_rect(rect(static_cast<coord>(xa), static_cast<coord>(y), static_cast<dim>(xb - xa), 1), true);
+            }
+        }
+        return *this;
+    }
+
+    gpx &gpx::draw_path(const path &p)
+    {
+        const auto &v = p.vertices();
+        const auto at = [&](std::size_t i) {
+            return point(static_cast<coord>(std::lround(v[i].x)), static_cast<coord>(std::lround(v[i].y)));
+        };
+
+        for (const auto &c : p.contours())
+        {
+            for (std::size_t i = 1; i < c.count; ++i)
+                draw_line(at(c.first + i - 1), at(c.first + i));
+            if (c.closed && c.count > 2)
+                draw_line(at(c.first + c.count - 1), at(c.first));
+        }
+        return *this;
+    }
+}
@@ -3,6 +3,7 @@
 #include <interface/View.h>
 #include <Application.h>
 #include <AppDefs.h>
+#include <OS.h>
 
 #include <native.h>
 
@@ -55,10 +56,12 @@ namespace
             if (!_owner)
                 return;
 
-            _owner->on_mouse_move.emit(
+            _owner->on_native_motion(
                 native::point(
                     static_cast<native::coord>(where.x),
-                    static_cast<native::coord>(where.y)));
+                    static_cast<native::coord>(where.y)),
+                static_cast<uint32_t>(system_time() / 1000));
+            _owner->flush_native_motion();
         }
 
         void MouseDown(BPoint where) override
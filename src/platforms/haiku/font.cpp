@@ -86,11 +86,8 @@ font_t font_t::create(const font_spec &spec)
 const font_t &font_t::stock(font_role role)
 {
     static font_t s[5];
-    static bool initialized = false;
-    if (!initialized)
-    {
-        initialized = true;
-
+    static std::once_flag once;
+    std::call_once(once, []() {
         s[(int)font_role::system]._id  = register_font(*be_plain_font);
         s[(int)font_role::fixed]._id   = register_font(*be_fixed_font);
         s[(int)font_role::title]._id   = register_font(*be_bold_font);
@@ -99,7 +96,7 @@ const font_t &font_t::stock(font_role role)
         BFont small = *be_plain_font;
         small.SetSize(std::max(8.0f, be_plain_font->Size() * 0.85f));
         s[(int)font_role::small_]._id = register_font(small);
-    }
+    });
     return s[(int)role];
 }
 
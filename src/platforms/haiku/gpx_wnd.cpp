@@ -6,11 +6,13 @@
 #include <View.h>
 #include <Bitmap.h>
 #include <Region.h>
+#include <Shape.h>
 #include <String.h>
 
 #include <native.h>
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 static void apply_bview_state(BView *view, native::gpx_wnd *self, haiku::haikugpx *cache)
 {
@@ -203,4 +205,94 @@ namespace native
         return *this;
     }
 
+    gpx &gpx_wnd::copy_area(const rect &src, point dst)
+    {
+        auto *cache = haiku::wnd_gpx_bindings.from_a(_wnd);
+        if (!cache || !cache->view)
+            return *this;
+
+        with_locked_view(cache->view, [&](BView *view) {
+            const BRect b = view->Bounds();
+            rect s = src;
+            point d = dst;
+            if (!detail::clip_copy(_clip, rect(0, 0, static_cast<dim>(b.Width() + 1), static_cast<dim>(b.Height() + 1)), s, d))
+                return;
+
+            view->CopyBits(BRect(s.p.x, s.p.y, s.p.x + s.d.w - 1, s.p.y + s.d.h - 1),
+                           BRect(d.x, d.y, d.x + s.d.w - 1, d.y + s.d.h - 1));
+        });
+
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+    {
+        auto *cache = haiku::wnd_gpx_bindings.from_a(_wnd);
+        if (!cache || !cache->view)
+            return *this;
+
+        BShape shape;
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            for (std::size_t i = 0; i < c.count; ++i)
+            {
+                const BPoint q(v[c.first + i].x, v[c.first + i].y);
+                if (i == 0)
+                    shape.MoveTo(q);
+                else
+                    shape.LineTo(q);
+            }
+            shape.Close();
+        }
+
+        with_locked_view(cache->view, [&](BView *view) {
+            apply_bview_state(view, this, cache);
+            view->SetFillRule(rule == fill_rule::even_odd ? B_EVEN_ODD : B_NONZERO);
+            view->FillShape(&shape);
+        });
+
+        return *this;
+    }
+
+    gpx &gpx_wnd::draw_path(const path &p)
+    {
+        auto *cache = haiku::wnd_gpx_bindings.from_a(_wnd);
+        if (!cache || !cache->view)
+            return *this;
+
+        BShape shape;
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            for (std::size_t i = 0; i < c.count; ++i)
+            {
+                const BPoint q(v[c.first + i].x, v[c.first + i].y);
+                if (i == 0)
+                    shape.MoveTo(q);
+                else
+                    shape.LineTo(q);
+            }
+            if (c.closed)
+                shape.Close();
+        }
+
+        with_locked_view(cache->view, [&](BView *view) {
+            apply_bview_state(view, this, cache);
+            view->StrokeShape(&shape);
+        });
+
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        return gpx::fill_rect_gradient(r, g);
+    }
+
+    gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        return gpx::fill_rect_pattern(r, tile, origin);
+    }
+
 } // namespace native
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cmath>
+
+#include <Bitmap.h>
+
+#include "globals.h"
+#include "img_text_backend.h"
+
+namespace native
+{
+namespace detail
+{
+    // Only the text's box goes through an offscreen BBitmap, whose
+    // B_RGBA32 pixels are BGRA in memory. p is the baseline, as in
+    // gpx_wnd::draw_text().
+    bool img_text_backend_draw(const img &target,
+                               const rect &clip,
+                               rgba ink,
+                               const font_t &f,
+                               const std::string &text,
+                               point p)
+    {
+        auto *fh = haiku::font_bindings.from_a(f.id());
+        const BFont font = fh ? fh->bfont : *be_plain_font;
+        font_height height;
+        font.GetHeight(&height);
+
+        const int ascent = static_cast<int>(std::ceil(height.ascent));
+        const int descent = static_cast<int>(std::ceil(height.descent));
+        const int width = static_cast<int>(std::ceil(font.StringWidth(text.c_str())));
+        const rect box = clip.intersect(rect(p.x, static_cast<coord>(p.y - ascent),
+                                             static_cast<dim>(width), static_cast<dim>(ascent + descent)));
+        if (box.d.w == 0 || box.d.h == 0)
+            return true;
+
+        const BRect bounds(0, 0, box.d.w - 1, box.d.h - 1);
+        BBitmap bitmap(bounds, B_RGBA32, true);
+        if (!bitmap.IsValid())
+            return false;
+
+        rgba *pixels = const_cast<rgba *>(target.pixels());
+        uint8_t *bits = static_cast<uint8_t *>(bitmap.Bits());
+        const int row_bytes = bitmap.BytesPerRow();
+        for (int y = 0; y < box.d.h; ++y)
+        {
+            const rgba *in = pixels + (box.p.y + y) * target.w() + box.p.x;
+            uint8_t *out = bits + y * row_bytes;
+            for (int x = 0; x < box.d.w; ++x, out += 4)
+            {
+                out[0] = in[x].b;
+                out[1] = in[x].g;
+                out[2] = in[x].r;
+                out[3] = in[x].a;
+            }
+        }
+
+        // The bitmap owns and deletes the view.
+        BView *view = new BView(bounds, "img_text", B_FOLLOW_NONE, B_WILL_DRAW);
+        bitmap.AddChild(view);
+        if (!bitmap.Lock())
+            return false;
+        view->SetFont(&font);
+        view->SetHighColor(rgb_color{ink.r, ink.g, ink.b, ink.a});
+        view->SetDrawingMode(B_OP_OVER);
+        view->DrawString(text.c_str(), BPoint(p.x - box.p.x, p.y - box.p.y));
+        view->Sync();
+        bitmap.Unlock();
+
+        for (int y = 0; y < box.d.h; ++y)
+        {
+            rgba *out = pixels + (box.p.y + y) * target.w() + box.p.x;
+            const uint8_t *in = bits + y * row_bytes;
+            for (int x = 0; x < box.d.w; ++x, in += 4)
+                out[x] = rgba(in[2], in[1], in[0], out[x].a);
+        }
+        return true;
+    }
+}
+}
@@ -8,6 +8,7 @@
 
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 namespace
 {
@@ -254,4 +255,35 @@ namespace native
         return *_gpx;
     }
 
+
+    namespace detail
+    {
+        bool retain_backend_native(const wnd *)
+        {
+            // Draw() clears the update region before on_wnd_paint runs.
+            return false;
+        }
+
+        bool scroll_backend_native(wnd *w, const rect &r, const scroll_plan &plan)
+        {
+            BWindow *bwin = haiku::wnd_bindings.from_b(w);
+            if (!bwin)
+                return false;
+
+            // CopyBits moves the view's pixels in the app_server; only the
+            // strips that scroll into view are invalidated.
+            if (plan.src.d.w > 0 && plan.src.d.h > 0)
+            {
+                gpx &g = w->get_gpx();
+                const rect saved = g.clip();
+                g.set_clip(r).copy_area(plan.src, plan.dst);
+                g.set_clip(saved);
+            }
+
+            for (int i = 0; i < plan.strip_count; ++i)
+                w->invalidate(plan.strips[i]);
+            return true;
+        }
+    }
+
 } // namespace native
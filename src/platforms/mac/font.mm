@@ -95,11 +95,8 @@ font_t font_t::create(const font_spec &spec)
 const font_t &font_t::stock(font_role role)
 {
     static font_t s[5];
-    static bool initialized = false;
-    if (!initialized)
-    {
-        initialized = true;
-
+    static std::once_flag once;
+    std::call_once(once, []() {
         CGFloat sz       = [NSFont systemFontSize];
         CGFloat sz_small = [NSFont smallSystemFontSize];
 
@@ -112,7 +109,7 @@ const font_t &font_t::stock(font_role role)
         init(font_role::title,   [NSFont titleBarFontOfSize:sz]);
         init(font_role::small_,  [NSFont systemFontOfSize:sz_small]);
         init(font_role::control, [NSFont menuFontOfSize:0]);
-    }
+    });
     return s[(int)role];
 }
 
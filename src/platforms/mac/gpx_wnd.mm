@@ -208,4 +208,91 @@ namespace native
         return *this;
     }
 
+    gpx &gpx_wnd::copy_area(const rect &, point)
+    {
+        // AppKit views keep no pixels between draws that can be moved in
+        // place; wnd::scroll invalidates instead.
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+    {
+        auto *cache = mac::wnd_gpx_bindings.from_a(_wnd);
+        if (!cache || !cache->view)
+            return *this;
+
+        NSView *view = cache->view;
+        [view lockFocus];
+
+        NSGraphicsContext *context = [NSGraphicsContext currentContext];
+        apply_cocoa_state(context, this, cache);
+        CGContextRef cgContext = (CGContextRef)[context CGContext];
+
+        CGContextBeginPath(cgContext);
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            for (std::size_t i = 0; i < c.count; ++i)
+            {
+                if (i == 0)
+                    CGContextMoveToPoint(cgContext, v[c.first].x, v[c.first].y);
+                else
+                    CGContextAddLineToPoint(cgContext, v[c.first + i].x, v[c.first + i].y);
+            }
+            CGContextClosePath(cgContext);
+        }
+        if (rule == fill_rule::even_odd)
+            CGContextEOFillPath(cgContext);
+        else
+            CGContextFillPath(cgContext);
+
+        [view unlockFocus];
+        [view setNeedsDisplay:YES];
+        return *this;
+    }
+
+    gpx &gpx_wnd::draw_path(const path &p)
+    {
+        auto *cache = mac::wnd_gpx_bindings.from_a(_wnd);
+        if (!cache || !cache->view)
+            return *this;
+
+        NSView *view = cache->view;
+        [view lockFocus];
+
+        NSGraphicsContext *context = [NSGraphicsContext currentContext];
+        apply_cocoa_state(context, this, cache);
+        CGContextRef cgContext = (CGContextRef)[context CGContext];
+
+        CGContextBeginPath(cgContext);
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            for (std::size_t i = 0; i < c.count; ++i)
+            {
+                if (i == 0)
+                    CGContextMoveToPoint(cgContext, v[c.first].x, v[c.first].y);
+                else
+                    CGContextAddLineToPoint(cgContext, v[c.first + i].x, v[c.first + i].y);
+            }
+            if (c.closed)
+                CGContextClosePath(cgContext);
+        }
+        CGContextStrokePath(cgContext);
+
+        [view unlockFocus];
+        [view setNeedsDisplay:YES];
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        return gpx::fill_rect_gradient(r, g);
+    }
+
+    gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        return gpx::fill_rect_pattern(r, tile, origin);
+    }
+
 } // namespace native
@@ -0,0 +1,51 @@
+#include "globals.h"
+#include "img_text_backend.h"
+
+namespace native
+{
+namespace detail
+{
+    // A bitmap context straight over the image's pixels, flipped so that
+    // y runs down the rows as it does in a window.
+    bool img_text_backend_draw(const img &target,
+                               const rect &clip,
+                               rgba ink,
+                               const font_t &f,
+                               const std::string &text,
+                               point p)
+    {
+        @autoreleasepool
+        {
+            CGColorSpaceRef space = CGColorSpaceCreateDeviceRGB();
+            CGContextRef context = CGBitmapContextCreate(
+                const_cast<rgba *>(target.pixels()),
+                target.w(), target.h(), 8, target.w() * 4,
+                space,
+                kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big);
+            CGColorSpaceRelease(space);
+            if (!context)
+                return false;
+
+            CGContextTranslateCTM(context, 0, target.h());
+            CGContextScaleCTM(context, 1, -1);
+            CGContextClipToRect(context, CGRectMake(clip.p.x, clip.p.y, clip.d.w, clip.d.h));
+
+            auto *fh = mac::font_bindings.from_a(f.id());
+            NSFont *nsfont = fh ? fh->ns_font : [NSFont systemFontOfSize:[NSFont systemFontSize]];
+            NSColor *color = [NSColor colorWithRed:ink.r / 255.0 green:ink.g / 255.0 blue:ink.b / 255.0 alpha:ink.a / 255.0];
+            NSDictionary *attributes = @{
+                NSForegroundColorAttributeName: color,
+                NSFontAttributeName: nsfont
+            };
+
+            [NSGraphicsContext saveGraphicsState];
+            [NSGraphicsContext setCurrentContext:[NSGraphicsContext graphicsContextWithCGContext:context flipped:YES]];
+            [[NSString stringWithUTF8String:text.c_str()] drawAtPoint:NSMakePoint(p.x, p.y) withAttributes:attributes];
+            [NSGraphicsContext restoreGraphicsState];
+
+            CGContextRelease(context);
+        }
+        return true;
+    }
+}
+}
@@ -0,0 +1,92 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+
+namespace native
+{
+namespace detail
+{
+    mapped_file::~mapped_file()
+    {
+        close();
+    }
+
+    bool mapped_file::open(const std::string &path)
+    {
+        close();
+
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        _file = fd;
+        if (!remap())
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void mapped_file::close()
+    {
+        unmap();
+        if (_file != invalid)
+        {
+            ::close(static_cast<int>(_file));
+            _file = invalid;
+        }
+    }
+
+    uint64_t mapped_file::current_size() const
+    {
+        struct stat st;
+        if (_file == invalid || fstat(static_cast<int>(_file), &st) != 0)
+            return 0;
+        return static_cast<uint64_t>(st.st_size);
+    }
+
+    std::size_t mapped_file::read(uint64_t offset, char *out, std::size_t n) const
+    {
+        std::size_t done = 0;
+        while (_file != invalid && done < n)
+        {
+            const ssize_t got = pread(static_cast<int>(_file), out + done, n - done,
+                                      static_cast<off_t>(offset + done));
+            if (got <= 0)
+                break;
+            done += static_cast<std::size_t>(got);
+        }
+        return done;
+    }
+
+    bool mapped_file::remap()
+    {
+        unmap();
+
+        // An empty file cannot be mapped; it is simply open with no data.
+        const uint64_t n = current_size();
+        if (n == 0)
+            return _file != invalid;
+
+        void *p = mmap(nullptr, static_cast<size_t>(n), PROT_READ, MAP_SHARED, static_cast<int>(_file), 0);
+        if (p == MAP_FAILED)
+            return false;
+
+        _data = static_cast<const char *>(p);
+        _size = n;
+        return true;
+    }
+
+    void mapped_file::unmap()
+    {
+        if (_data)
+            munmap(const_cast<char *>(_data), static_cast<size_t>(_size));
+        _data = nullptr;
+        _size = 0;
+    }
+}
+}
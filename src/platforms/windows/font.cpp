@@ -84,11 +84,8 @@ font_t font_t::create(const font_spec &spec)
 const font_t &font_t::stock(font_role role)
 {
     static font_t s[5];
-    static bool initialized = false;
-    if (!initialized)
-    {
-        initialized = true;
-
+    static std::once_flag once;
+    std::call_once(once, []() {
         NONCLIENTMETRICSA ncm = {};
         ncm.cbSize = sizeof(ncm);
         SystemParametersInfoA(SPI_GETNONCLIENTMETRICS, sizeof(ncm), &ncm, 0);
@@ -118,7 +115,7 @@ const font_t &font_t::stock(font_role role)
         fixed.lfPitchAndFamily = FIXED_PITCH | FF_MODERN;
         strcpy_s(fixed.lfFaceName, LF_FACESIZE, "Courier New");
         s[(int)font_role::fixed] = make(fixed);
-    }
+    });
     return s[(int)role];
 }
 
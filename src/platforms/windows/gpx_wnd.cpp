@@ -1,9 +1,12 @@
+#include <cmath>
 #include <stdexcept>
+#include <vector>
 #include <windows.h>
 
 #include <native.h>
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 static void apply_gdi_state(HDC hdc, native::gpx_wnd *self, win::wingpx *cache)
 {
@@ -177,4 +180,96 @@ namespace native
         return *this;
     }
 
+    gpx &gpx_wnd::copy_area(const rect &src, point dst)
+    {
+        HWND hwnd = win::wnd_bindings.from_b(_wnd);
+        if (!hwnd)
+            return *this;
+
+        RECT client;
+        GetClientRect(hwnd, &client);
+
+        rect s = src;
+        point d = dst;
+        if (!detail::clip_copy(_clip, rect(0, 0, static_cast<dim>(client.right), static_cast<dim>(client.bottom)), s, d))
+            return *this;
+
+        // Same-DC BitBlt is overlap-safe.
+        HDC hdc = GetDC(hwnd);
+        BitBlt(hdc, d.x, d.y, s.d.w, s.d.h, hdc, s.p.x, s.p.y, SRCCOPY);
+        ReleaseDC(hwnd, hdc);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+    {
+        HWND hwnd = win::wnd_bindings.from_b(_wnd);
+        auto *cache = win::wnd_gpx_bindings.from_a(_wnd);
+        if (!hwnd || !cache)
+            return *this;
+
+        std::vector<POINT> points;
+        std::vector<INT> counts;
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            if (c.count < 2)
+                continue;
+            for (std::size_t i = 0; i < c.count; ++i)
+                points.push_back(POINT{std::lround(v[c.first + i].x), std::lround(v[c.first + i].y)});
+            counts.push_back(static_cast<INT>(c.count));
+        }
+        if (counts.empty())
+            return *this;
+
+        HDC hdc = GetDC(hwnd);
+        apply_gdi_state(hdc, this, cache);
+
+        // Brush only; the pen would outline the polygon.
+        HGDIOBJ pen = SelectObject(hdc, GetStockObject(NULL_PEN));
+        SetPolyFillMode(hdc, rule == fill_rule::even_odd ? ALTERNATE : WINDING);
+        PolyPolygon(hdc, points.data(), counts.data(), static_cast<int>(counts.size()));
+        SelectObject(hdc, pen);
+
+        ReleaseDC(hwnd, hdc);
+        return *this;
+    }
+
+    gpx &gpx_wnd::draw_path(const path &p)
+    {
+        HWND hwnd = win::wnd_bindings.from_b(_wnd);
+        auto *cache = win::wnd_gpx_bindings.from_a(_wnd);
+        if (!hwnd || !cache)
+            return *this;
+
+        HDC hdc = GetDC(hwnd);
+        apply_gdi_state(hdc, this, cache);
+
+        std::vector<POINT> points;
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            points.clear();
+            for (std::size_t i = 0; i < c.count; ++i)
+                points.push_back(POINT{std::lround(v[c.first + i].x), std::lround(v[c.first + i].y)});
+            if (c.closed && c.count > 2)
+                points.push_back(points.front());
+            if (points.size() > 1)
+                Polyline(hdc, points.data(), static_cast<int>(points.size()));
+        }
+
+        ReleaseDC(hwnd, hdc);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        return gpx::fill_rect_gradient(r, g);
+    }
+
+    gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        return gpx::fill_rect_pattern(r, tile, origin);
+    }
+
 } // namespace native
@@ -0,0 +1,91 @@
+#include <algorithm>
+
+#include "globals.h"
+#include "img_text_backend.h"
+
+namespace native
+{
+namespace detail
+{
+    // Only the text's box goes through a DIB section, converted to GDI's
+    // BGRA and back. GDI clears the alpha of pixels it draws on, so the
+    // image keeps its own.
+    bool img_text_backend_draw(const img &target,
+                               const rect &clip,
+                               rgba ink,
+                               const font_t &f,
+                               const std::string &text,
+                               point p)
+    {
+        HDC hdc = CreateCompatibleDC(nullptr);
+        if (!hdc)
+            return false;
+
+        auto *fh = win::font_bindings.from_a(f.id());
+        HGDIOBJ font = fh && fh->hfont ? static_cast<HGDIOBJ>(fh->hfont) : GetStockObject(DEFAULT_GUI_FONT);
+        HGDIOBJ old_font = SelectObject(hdc, font);
+
+        SIZE extent = {};
+        GetTextExtentPoint32A(hdc, text.c_str(), static_cast<int>(text.size()), &extent);
+        const rect box = clip.intersect(rect(p.x, p.y, static_cast<dim>(extent.cx), static_cast<dim>(extent.cy)));
+        if (box.d.w == 0 || box.d.h == 0)
+        {
+            SelectObject(hdc, old_font);
+            DeleteDC(hdc);
+            return true;
+        }
+
+        BITMAPINFO bmi = {};
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = box.d.w;
+        bmi.bmiHeader.biHeight = -static_cast<LONG>(box.d.h); // Top-down
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+
+        void *bits = nullptr;
+        HBITMAP hbm = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+        if (!hbm)
+        {
+            SelectObject(hdc, old_font);
+            DeleteDC(hdc);
+            return false;
+        }
+        HGDIOBJ old_bitmap = SelectObject(hdc, hbm);
+
+        rgba *pixels = const_cast<rgba *>(target.pixels());
+        uint8_t *dib = static_cast<uint8_t *>(bits);
+        for (int y = 0; y < box.d.h; ++y)
+        {
+            const rgba *in = pixels + (box.p.y + y) * target.w() + box.p.x;
+            uint8_t *out = dib + y * box.d.w * 4;
+            for (int x = 0; x < box.d.w; ++x, out += 4)
+            {
+                out[0] = in[x].b;
+                out[1] = in[x].g;
+                out[2] = in[x].r;
+                out[3] = in[x].a;
+            }
+        }
+
+        SetTextColor(hdc, RGB(ink.r, ink.g, ink.b));
+        SetBkMode(hdc, TRANSPARENT);
+        TextOutA(hdc, p.x - box.p.x, p.y - box.p.y, text.c_str(), static_cast<int>(text.size()));
+        GdiFlush();
+
+        for (int y = 0; y < box.d.h; ++y)
+        {
+            rgba *out = pixels + (box.p.y + y) * target.w() + box.p.x;
+            const uint8_t *in = dib + y * box.d.w * 4;
+            for (int x = 0; x < box.d.w; ++x, in += 4)
+                out[x] = rgba(in[2], in[1], in[0], out[x].a);
+        }
+
+        SelectObject(hdc, old_bitmap);
+        SelectObject(hdc, old_font);
+        DeleteObject(hbm);
+        DeleteDC(hdc);
+        return true;
+    }
+}
+}
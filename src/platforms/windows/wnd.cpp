@@ -8,6 +8,7 @@
 
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 namespace win
 {
@@ -79,7 +80,10 @@ namespace win
         }
 
         case WM_MOUSEMOVE:
-            wnd->on_mouse_move.emit(native::point(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam)));
+            // Windows already coalesces WM_MOUSEMOVE; each one is a batch.
+            wnd->on_native_motion(native::point(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam)),
+                                  static_cast<uint32_t>(GetMessageTime()));
+            wnd->flush_native_motion();
             break;
 
         case WM_LBUTTONDOWN:
@@ -407,4 +411,34 @@ namespace native
 
         return *_gpx;
     }
+
+    namespace detail
+    {
+        bool retain_backend_native(const wnd *)
+        {
+            // WM_PAINT clears the update region before on_wnd_paint runs.
+            return false;
+        }
+
+        bool scroll_backend_native(wnd *w, const rect &r, const scroll_plan &plan)
+        {
+            HWND hwnd = win::wnd_bindings.from_b(w);
+            if (!hwnd)
+                return false;
+
+            // Nothing survives a scroll by the full extent.
+            if (plan.src.d.w == 0 || plan.src.d.h == 0)
+                return false;
+
+            // ScrollWindowEx moves the on-screen pixels and adds only the
+            // uncovered strip to the update region.
+            RECT area = {r.p.x, r.p.y, r.x2(), r.y2()};
+            ScrollWindowEx(hwnd,
+                           plan.dst.x - plan.src.p.x,
+                           plan.dst.y - plan.src.p.y,
+                           &area, &area, nullptr, nullptr, SW_INVALIDATE);
+            return true;
+        }
+    }
+
 } // namespace native
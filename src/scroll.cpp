@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include <native.h>
+
+#include "frame_scheduler.h"
+#include "scroll.h"
+
+namespace native
+{
+namespace detail
+{
+    scroll_plan plan_scroll(const rect &r, int dx, int dy)
+    {
+        scroll_plan plan;
+        const int w = r.d.w;
+        const int h = r.d.h;
+        if (w == 0 || h == 0)
+            return plan;
+
+        if (std::abs(dx) >= w || std::abs(dy) >= h)
+        {
+            plan.strips[plan.strip_count++] = r;
+            return plan;
+        }
+
+        const int kept_w = w - std::abs(dx);
+        const int kept_h = h - std::abs(dy);
+        const int dst_x = r.p.x + std::max(dx, 0);
+        const int dst_y = r.p.y + std::max(dy, 0);
+
+        plan.dst = point(static_cast<coord>(dst_x), static_cast<coord>(dst_y));
+        plan.src = rect(static_cast<coord>(dst_x - dx), static_cast<coord>(dst_y - dy),
+                        static_cast<dim>(kept_w), static_cast<dim>(kept_h));
+
+        // Full-width band for the vertical move, then the side band for
+        // the horizontal move beside the kept rows.
+        if (dy > 0)
+            plan.strips[plan.strip_count++] = rect(r.p.x, r.p.y, r.d.w, static_cast<dim>(dy));
+        else if (dy < 0)
+            plan.strips[plan.strip_count++] = rect(r.p.x, static_cast<coord>(r.p.y + kept_h),
+                                                   r.d.w, static_cast<dim>(-dy));
+
+        if (dx > 0)
+            plan.strips[plan.strip_count++] = rect(r.p.x, static_cast<coord>(dst_y),
+                                                   static_cast<dim>(dx), static_cast<dim>(kept_h));
+        else if (dx < 0)
+            plan.strips[plan.strip_count++] = rect(static_cast<coord>(r.p.x + kept_w), static_cast<coord>(dst_y),
+                                                   static_cast<dim>(-dx), static_cast<dim>(kept_h));
+        return plan;
+    }
+
+    bool clip_copy(const rect &clip, const rect &bounds, rect &src, point &dst)
+    {
+        // Work in int: offsets between src and dst can exceed coord.
+        const int ox = dst.x - src.p.x;
+        const int oy = dst.y - src.p.y;
+
+        int x1 = std::max<int>(src.p.x, bounds.p.x);
+        int y1 = std::max<int>(src.p.y, bounds.p.y);
+        int x2 = std::min<int>(src.p.x + src.d.w, bounds.p.x + bounds.d.w);
+        int y2 = std::min<int>(src.p.y + src.d.h, bounds.p.y + bounds.d.h);
+
+        x1 = std::max<int>(x1, std::max<int>(clip.p.x, bounds.p.x) - ox);
+        y1 = std::max<int>(y1, std::max<int>(clip.p.y, bounds.p.y) - oy);
+        x2 = std::min<int>(x2, std::min<int>(clip.p.x + clip.d.w, bounds.p.x + bounds.d.w) - ox);
+        y2 = std::min<int>(y2, std::min<int>(clip.p.y + clip.d.h, bounds.p.y + bounds.d.h) - oy);
+
+        if (x1 >= x2 || y1 >= y2)
+            return false;
+
+        src = rect(static_cast<coord>(x1), static_cast<coord>(y1),
+                   static_cast<dim>(x2 - x1), static_cast<dim>(y2 - y1));
+        dst = point(static_cast<coord>(x1 + ox), static_cast<coord>(y1 + oy));
+        return true;
+    }
+
+    void scroll_retained(wnd *w, const rect &r, const scroll_plan &plan)
+    {
+        if (plan.src.d.w > 0 && plan.src.d.h > 0)
+        {
+            gpx &g = w->get_gpx();
+            const rect saved = g.clip();
+            g.set_clip(r).copy_area(plan.src, plan.dst);
+            g.set_clip(saved);
+        }
+        scroll_damage(w, r, plan);
+    }
+
+    void scroll_damage(wnd *w, const rect &r, const scroll_plan &plan)
+    {
+        if (plan.src.d.w > 0 && plan.src.d.h > 0)
+        {
+            // Damage not yet painted was copied along with its pixels; it
+            // must follow them, or the copy shows stale pixels that no
+            // later paint covers.
+            frames().scroll(w, r, plan.dst.x - plan.src.p.x, plan.dst.y - plan.src.p.y);
+            frames().present(w, r);
+        }
+
+        for (int i = 0; i < plan.strip_count; ++i)
+            frames().request(w, plan.strips[i]);
+    }
+}
+}
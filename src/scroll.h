@@ -0,0 +1,42 @@
+#pragma once
+
+#include <native.h>
+
+namespace native
+{
+namespace detail
+{
+    // A scroll of r by (dx, dy), split into the pixels that move and the
+    // strips that become exposed. Positive dx/dy move contents right/down.
+    struct scroll_plan
+    {
+        rect src;        // Pixels that stay visible, before the move
+        point dst;       // Where src.p lands
+        rect strips[2];  // Newly exposed areas
+        int strip_count = 0;
+    };
+
+    scroll_plan plan_scroll(const rect &r, int dx, int dy);
+
+    // Trims a copy of src to dst so the destination stays inside clip and
+    // the source inside bounds. Returns false when nothing is left.
+    bool clip_copy(const rect &clip, const rect &bounds, rect &src, point &dst);
+
+    // Shared path for backends with a retained backbuffer and the frame
+    // scheduler: copies the moving pixels, then calls scroll_damage().
+    void scroll_retained(wnd *w, const rect &r, const scroll_plan &plan);
+
+    // Scheduler side of a scroll whose pixels have been copied: moves the
+    // damage still pending in r with them, presents r and damages the
+    // exposed strips.
+    void scroll_damage(wnd *w, const rect &r, const scroll_plan &plan);
+
+    // Backend hook for wnd::scroll. Returns false when the backend has no
+    // retained pixels to move; wnd::scroll then invalidates r instead.
+    bool scroll_backend_native(wnd *w, const rect &r, const scroll_plan &plan);
+
+    // Backend hook for wnd::contents_retained: whether the backend keeps
+    // a window's pixels from one paint to the next.
+    bool retain_backend_native(const wnd *w);
+}
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <native.h>
+
+namespace native
+{
+    using extent = series_pyramid::extent;
+
+    static extent empty_extent()
+    {
+        return extent{std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+    }
+
+    static void merge(extent &e, const extent &o)
+    {
+        e.lo = std::min(e.lo, o.lo);
+        e.hi = std::max(e.hi, o.hi);
+    }
+
+    // Min and max of p[0, n), four lanes at a time where SSE is there.
+    static extent reduce(const float *p, std::size_t n)
+    {
+        extent e = empty_extent();
+        std::size_t i = 0;
+
+#if defined(__SSE2__)
+        if (n >= 4)
+        {
+            __m128 lo = _mm_loadu_ps(p);
+            __m128 hi = lo;
+            for (i = 4; i + 4 <= n; i += 4)
+            {
+                const __m128 v = _mm_loadu_ps(p + i);
+                lo = _mm_min_ps(lo, v);
+                hi = _mm_max_ps(hi, v);
+            }
+
+            alignas(16) float l[4], h[4];
+            _mm_store_ps(l, lo);
+            _mm_store_ps(h, hi);
+            e.lo = std::min(std::min(l[0], l[1]), std::min(l[2], l[3]));
+            e.hi = std::max(std::max(h[0], h[1]), std::max(h[2], h[3]));
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            e.lo = std::min(e.lo, p[i]);
+            e.hi = std::max(e.hi, p[i]);
+        }
+        return e;
+    }
+
+    void series_pyramid::update(const float *ys, std::size_t n)
+    {
+        if (n < _size)
+            clear();
+        if (_levels.empty())
+            _levels.emplace_back();
+
+        // Whole blocks only, so a block never has to be revisited.
+        std::vector<extent> &base = _levels[0];
+        for (std::size_t b = base.size(); (b + 1) * block <= n; ++b)
+            base.push_back(reduce(ys + b * block, block));
+
+        for (std::size_t l = 1; _levels[l - 1].size() >= fanout; ++l)
+        {
+            if (l == _levels.size())
+                _levels.emplace_back();
+
+            const std::vector<extent> &below = _levels[l - 1];
+            std::vector<extent> &level = _levels[l];
+            for (std::size_t b = level.size(); (b + 1) * fanout <= below.size(); ++b)
+            {
+                extent e = below[b * fanout];
+                for (std::size_t k = 1; k < fanout; ++k)
+                    merge(e, below[b * fanout + k]);
+                level.push_back(e);
+            }
+        }
+
+        _size = n;
+    }
+
+    void series_pyramid::clear()
+    {
+        _levels.clear();
+        _size = 0;
+    }
+
+    std::size_t series_pyramid::size() const
+    {
+        return _size;
+    }
+
+    extent series_pyramid::range(const float *ys, std::size_t first, std::size_t last) const
+    {
+        extent e = empty_extent();
+        std::size_t a = first;
+        while (a < last)
+        {
+            // Take the largest stored block that starts at a and ends by
+            // last; up to fanout - 1 of them per level on each side.
+            if (a % block == 0 && !_levels.empty() && a / block < _levels[0].size() && a + block <= last)
+            {
+                std::size_t l = 0;
+                std::size_t span = block;
+                while (l + 1 < _levels.size() &&
+                       a % (span * fanout) == 0 &&
+                       a + span * fanout <= last &&
+                       a / (span * fanout) < _levels[l + 1].size())
+                {
+                    span *= fanout;
+                    ++l;
+                }
+
+                merge(e, _levels[l][a / span]);
+                a += span;
+                continue;
+            }
+
+            // Samples before the next block edge, or past the pyramid.
+            const std::size_t end = a / block < (_levels.empty() ? 0 : _levels[0].size())
+                                        ? std::min(last, (a / block + 1) * block)
+                                        : last;
+            merge(e, reduce(ys + a, end - a));
+            a = end;
+        }
+        return e;
+    }
+
+    gpx &gpx::draw_series(const float *ys, std::size_t n, double x0, double dx,
+                          const rect &r, float y_lo, float y_hi,
+                          const series_pyramid *pyramid)
+    {
+        if (!ys || n == 0 || !(dx > 0) || y_hi == y_lo)
+            return *this;
+
+        // Only the columns inside the clip are looked at. Thick pens and
+        // round caps would reach past r, so r clips the strokes too.
+        const rect old_clip = clip();
+        const rect area = old_clip.intersect(r);
+        if (area.d.w == 0 || area.d.h == 0)
+            return *this;
+        set_clip(area);
+
+        const int c0 = area.p.x - r.p.x;
+        const int c1 = c0 + area.d.w;
+        const double scale = (r.d.h - 1) / static_cast<double>(y_hi - y_lo);
+        const auto to_y = [&](float v) {
+            const double y = r.p.y + (y_hi - v) * scale;
+            return static_cast<coord>(std::lround(std::max<double>(r.p.y, std::min<double>(r.p.y + r.d.h - 1, y))));
+        };
+
+        if (dx < 1)
+        {
+            // More columns than samples: a polyline through the samples,
+            // from the one before the first column to the one after the
+            // last.
+            const auto to_x = [&](std::size_t i) {
+                const double x = r.p.x + (static_cast<double>(i) - x0) / dx;
+                return static_cast<coord>(std::lround(std::max<double>(r.p.x, std::min<double>(r.p.x + r.d.w - 1, x))));
+            };
+            const double s0 = std::floor(x0 + c0 * dx);
+            const double s1 = std::ceil(x0 + c1 * dx);
+            const std::size_t i0 = s0 <= 0 ? 0 : static_cast<std::size_t>(std::min<double>(s0, n - 1));
+            const std::size_t i1 = s1 <= 0 ? 0 : static_cast<std::size_t>(std::min<double>(s1, n - 1));
+            for (std::size_t i = i0; i < i1; ++i)
+                draw_line(point(to_x(i), to_y(ys[i])), point(to_x(i + 1), to_y(ys[i + 1])));
+            set_clip(old_clip);
+            return *this;
+        }
+
+        for (int c = c0; c < c1; ++c)
+        {
+            const double sa = std::floor(x0 + c * dx);
+            const double sb = std::floor(x0 + (c + 1) * dx);
+            if (sb <= 0 || sa >= static_cast<double>(n))
+                continue;
+
+            const std::size_t a = sa <= 0 ? 0 : static_cast<std::size_t>(sa);
+            const std::size_t b = std::min(n, static_cast<std::size_t>(sb));
+            if (a >= b)
+                continue;
+
+            // The sample before the column joins it to the column on the
+            // left, as the line from that column's last sample would.
+            const std::size_t from = a > 0 ? a - 1 : a;
+            const extent e = pyramid ? pyramid->range(ys, from, b) : reduce(ys + from, b - from);
+
+            const coord x = static_cast<coord>(r.p.x + c);
+            draw_line(point(x, to_y(e.hi)), point(x, to_y(e.lo)));
+        }
+        set_clip(old_clip);
+        return *this;
+    }
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <native.h>
+#include <bindings.h>
+
+namespace native
+{
+namespace detail
+{
+    // Uniform grid over a window's coordinate space for hit-testing its
+    // child controls. Each item is listed in every 64x64 cell its bounds
+    // touch, so a point query looks at one cell instead of every item.
+    // Items that would span more than max_cells cells are kept on a
+    // short list that every query checks instead. Items are ordered by
+    // insertion, which is also the paint order.
+    template <typename T>
+    class spatial_grid
+    {
+    public:
+        // Adds item, or moves it to r if it is already indexed. A moved
+        // item keeps its place in the order.
+        void place(T *item, const rect &r)
+        {
+            std::size_t i = _items.find(item);
+            entry e;
+            if (i != _items.npos)
+            {
+                e = _items.value(i);
+                if (e.bounds.p.x == r.p.x && e.bounds.p.y == r.p.y &&
+                    e.bounds.d.w == r.d.w && e.bounds.d.h == r.d.h)
+                    return;
+                unlink(item, e.bounds);
+            }
+            else
+            {
+                if (_order.size() >= 16 && _holes * 2 > _order.size())
+                    compact();
+                e.seq = _next_seq++;
+                e.pos = _order.size();
+                _order.push_back(item);
+            }
+
+            e.bounds = r;
+            _items.insert(item, e);
+            link(item, e);
+        }
+
+        // Leaves a hole in the order rather than closing it, so erasing
+        // does not depend on the number of items; place() compacts the
+        // order once holes make up half of it.
+        void erase(T *item)
+        {
+            const std::size_t i = _items.find(item);
+            if (i == _items.npos)
+                return;
+
+            const entry e = _items.value(i);
+            unlink(item, e.bounds);
+            _items.erase_at(i);
+            _order[e.pos] = nullptr;
+            ++_holes;
+        }
+
+        bool contains(T *item) const { return _items.find(item) != _items.npos; }
+        std::size_t size() const { return _order.size() - _holes; }
+
+        // Calls f(item) for every item, in paint order. f may move or
+        // erase items, but not add them.
+        template <typename F>
+        void each(F &&f) const
+        {
+            for (std::size_t i = 0; i < _order.size(); ++i)
+            {
+                if (T *item = _order[i])
+                    f(item);
+            }
+        }
+
+        // The topmost item, last in paint order, whose bounds contain p
+        // and for which accept(item) is true; nullptr if there is none.
+        template <typename F>
+        T *at(point p, F &&accept) const
+        {
+            const ref *top = nullptr;
+            const auto scan = [&](const std::vector<ref> &bucket) {
+                for (const ref &m : bucket)
+                {
+                    if ((!top || m.seq > top->seq) && hit(m.bounds, p) && accept(m.item))
+                        top = &m;
+                }
+            };
+
+            const std::size_t c = _cells.find(key(p.x >> shift, p.y >> shift));
+            if (c != _cells.npos)
+                scan(_buckets[_cells.value(c)]);
+            scan(_wide);
+            return top ? top->item : nullptr;
+        }
+
+        T *at(point p) const
+        {
+            return at(p, [](T *) { return true; });
+        }
+
+        // Replaces the contents of out with the items whose bounds
+        // intersect r, in paint order. Callers keep out between queries,
+        // so that repeated queries do not allocate.
+        void in(const rect &r, std::vector<T *> &out) const
+        {
+            out.clear();
+            _hits.clear();
+            if (r.d.w > 0 && r.d.h > 0)
+            {
+                const span s = span_of(r);
+                for (int cy = s.y0; cy <= s.y1; ++cy)
+                {
+                    for (int cx = s.x0; cx <= s.x1; ++cx)
+                    {
+                        const std::size_t c = _cells.find(key(cx, cy));
+                        if (c == _cells.npos)
+                            continue;
+
+                        // An item listed in several cells of the query
+                        // is taken from the first of them only.
+                        for (const ref &m : _buckets[_cells.value(c)])
+                        {
+                            const span ms = span_of(m.bounds);
+                            if (cx == std::max(s.x0, ms.x0) && cy == std::max(s.y0, ms.y0) && hit(m.bounds, r))
+                                _hits.push_back(m);
+                        }
+                    }
+                }
+                for (const ref &m : _wide)
+                {
+                    if (hit(m.bounds, r))
+                        _hits.push_back(m);
+                }
+            }
+
+            std::sort(_hits.begin(), _hits.end(), [](const ref &a, const ref &b) {
+                return a.seq < b.seq;
+            });
+            for (const ref &m : _hits)
+                out.push_back(m.item);
+        }
+
+    private:
+        static constexpr int shift = 6;
+        static constexpr int max_cells = 64;
+
+        struct entry
+        {
+            rect bounds;
+            uint32_t seq = 0;
+            std::size_t pos = 0; // Index in _order.
+        };
+
+        // Bucket member; carries the bounds so queries need no lookup.
+        struct ref
+        {
+            T *item;
+            rect bounds;
+            uint32_t seq;
+        };
+
+        struct span
+        {
+            int x0, y0, x1, y1;
+            int cells() const { return (x1 - x0 + 1) * (y1 - y0 + 1); }
+        };
+
+        static span span_of(const rect &r)
+        {
+            const int x = r.p.x;
+            const int y = r.p.y;
+            return span{x >> shift, y >> shift,
+                        (x + (r.d.w ? r.d.w - 1 : 0)) >> shift,
+                        (y + (r.d.h ? r.d.h - 1 : 0)) >> shift};
+        }
+
+        static uint64_t key(int cx, int cy)
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(cy)) << 32) |
+                   static_cast<uint32_t>(cx);
+        }
+
+        static bool hit(const rect &b, point p)
+        {
+            return p.x >= b.p.x && p.y >= b.p.y &&
+                   p.x < b.p.x + b.d.w && p.y < b.p.y + b.d.h;
+        }
+
+        static bool hit(const rect &b, const rect &r)
+        {
+            return b.p.x < r.p.x + r.d.w && r.p.x < b.p.x + b.d.w &&
+                   b.p.y < r.p.y + r.d.h && r.p.y < b.p.y + b.d.h;
+        }
+
+        static void drop(std::vector<ref> &bucket, T *item)
+        {
+            bucket.erase(std::find_if(bucket.begin(), bucket.end(),
+                                      [item](const ref &m) { return m.item == item; }));
+        }
+
+        void link(T *item, const entry &e)
+        {
+            const rect &r = e.bounds;
+            if (r.d.w == 0 || r.d.h == 0)
+                return;
+
+            const ref m{item, r, e.seq};
+            const span s = span_of(r);
+            if (s.cells() > max_cells)
+            {
+                _wide.push_back(m);
+                return;
+            }
+
+            for (int cy = s.y0; cy <= s.y1; ++cy)
+            {
+                for (int cx = s.x0; cx <= s.x1; ++cx)
+                {
+                    const uint64_t k = key(cx, cy);
+                    std::size_t c = _cells.find(k);
+                    if (c == _cells.npos)
+                    {
+                        _cells.insert(k, static_cast<uint32_t>(_buckets.size()));
+                        _buckets.emplace_back();
+                        c = _cells.find(k);
+                    }
+                    _buckets[_cells.value(c)].push_back(m);
+                }
+            }
+        }
+
+        // Closes the holes in the order and renumbers what moved.
+        void compact()
+        {
+            std::size_t n = 0;
+            for (T *item : _order)
+            {
+                if (!item)
+                    continue;
+                _items.value(_items.find(item)).pos = n;
+                _order[n++] = item;
+            }
+            _order.resize(n);
+            _holes = 0;
+        }
+
+        void unlink(T *item, const rect &r)
+        {
+            if (r.d.w == 0 || r.d.h == 0)
+                return;
+
+            const span s = span_of(r);
+            if (s.cells() > max_cells)
+            {
+                drop(_wide, item);
+                return;
+            }
+
+            for (int cy = s.y0; cy <= s.y1; ++cy)
+            {
+                for (int cx = s.x0; cx <= s.x1; ++cx)
+                {
+                    const std::size_t c = _cells.find(key(cx, cy));
+                    if (c == _cells.npos)
+                        continue;
+                    drop(_buckets[_cells.value(c)], item);
+                }
+            }
+        }
+
+        flat_map<T *, entry> _items;
+        flat_map<uint64_t, uint32_t> _cells;
+        std::vector<std::vector<ref>> _buckets;
+        std::vector<ref> _wide;
+        std::vector<T *> _order; // nullptr where an item was erased.
+        std::size_t _holes = 0;
+        uint32_t _next_seq = 0;
+        mutable std::vector<ref> _hits; // Scratch for in().
+    };
+}
+}
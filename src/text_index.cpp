@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "text_index.h"
+
+namespace native
+{
+namespace detail
+{
+    text_index::~text_index()
+    {
+        close();
+    }
+
+    bool text_index::open(const std::string &path)
+    {
+        close();
+        if (!_file.open(path))
+            return false;
+
+        _starts.assign(1, 0);
+        _scanned = 0;
+        _stop = false;
+        _worker = std::thread([this] { run(); });
+        return true;
+    }
+
+    void text_index::close()
+    {
+        if (_worker.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                _stop = true;
+            }
+            _wake.notify_all();
+            _worker.join();
+        }
+
+        _file.close();
+        _starts.clear();
+        _scanned = 0;
+    }
+
+    text_index::progress text_index::snapshot() const
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        progress p;
+        p.lines = lines_locked();
+        p.bytes = _scanned;
+        p.complete = _scanned == _file.size();
+        p.generation = _generation;
+        return p;
+    }
+
+    std::string text_index::line(std::size_t i, std::size_t max_bytes) const
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (i >= lines_locked())
+            return std::string();
+
+        // Read from the file rather than the mapping: if the file was
+        // truncated since the last check, the mapping faults past its new
+        // end, while a read just comes back short.
+        const uint64_t begin = _starts[i];
+        const uint64_t end = i + 1 < _starts.size() ? _starts[i + 1] - 1 : _scanned;
+        const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(end - begin, max_bytes));
+
+        std::string s(n, '\0');
+        s.resize(_file.read(begin, &s[0], n));
+        if (!s.empty() && s.size() == end - begin && s.back() == '\r')
+            s.pop_back();
+        return s;
+    }
+
+    // A trailing line without a newline counts once it has any bytes.
+    std::size_t text_index::lines_locked() const
+    {
+        if (_starts.empty())
+            return 0;
+        return _starts.size() - (_starts.back() == _scanned ? 1 : 0);
+    }
+
+    void text_index::scan(const char *p, std::size_t n, uint64_t base, std::vector<uint64_t> &starts)
+    {
+        std::size_t i = 0;
+
+#if defined(__SSE2__)
+        // Sixteen bytes per compare; the mask has one bit per newline.
+        const __m128i nl = _mm_set1_epi8('\n');
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+            while (mask)
+            {
+                starts.push_back(base + i + static_cast<unsigned>(__builtin_ctz(mask)) + 1);
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        while (i < n)
+        {
+            const void *hit = std::memchr(p + i, '\n', n - i);
+            if (!hit)
+                break;
+            i = static_cast<std::size_t>(static_cast<const char *>(hit) - p) + 1;
+            starts.push_back(base + i);
+        }
+    }
+
+    void text_index::run()
+    {
+        std::vector<uint64_t> found;
+        std::unique_lock<std::mutex> guard(_lock);
+
+        while (!_stop)
+        {
+            // Only this thread remaps, so the mapping can be read
+            // without the lock while a chunk is scanned. Touching it past
+            // the end of a file truncated since it was mapped raises
+            // SIGBUS, so the size is checked before every chunk.
+            if (_scanned < _file.size())
+            {
+                const uint64_t size = _file.current_size();
+                if (size < _file.size())
+                {
+                    if (!_file.remap() || size < _scanned)
+                        restart();
+                    continue;
+                }
+
+                const uint64_t from = _scanned;
+                const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(chunk_bytes, _file.size() - from));
+                const char *p = _file.data() + from;
+
+                guard.unlock();
+                found.clear();
+                scan(p, n, from, found);
+                guard.lock();
+
+                _starts.insert(_starts.end(), found.begin(), found.end());
+                _scanned = from + n;
+                continue;
+            }
+
+            _wake.wait_for(guard, std::chrono::milliseconds(poll_ms));
+            if (_stop)
+                break;
+
+            const uint64_t size = _file.current_size();
+            if (size == _file.size())
+                continue;
+
+            // A failed remap leaves nothing mapped, so the index goes too.
+            if (!_file.remap() || size < _scanned)
+                restart();
+        }
+    }
+
+    void text_index::restart()
+    {
+        _starts.assign(1, 0);
+        _scanned = 0;
+        ++_generation;
+    }
+}
+}
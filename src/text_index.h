@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace native
+{
+namespace detail
+{
+    // Line index of a mapped text file, built by a background thread.
+    // The thread scans the mapping in chunks, publishes the line starts
+    // of each chunk and, once it reaches the end, keeps polling the file
+    // size: growth is mapped and scanned, a shrunk file is indexed again
+    // from the start. The size is also checked before every chunk, so a
+    // truncation is seen before the scan reaches past the new end.
+    // Readers take a snapshot and read lines under the same lock that
+    // guards remapping; lines are read from the file, not the mapping.
+    class text_index
+    {
+    public:
+        struct progress
+        {
+            std::size_t lines = 0;
+            uint64_t bytes = 0;      // Indexed so far
+            bool complete = false;
+            uint64_t generation = 0; // Bumped when the file was truncated
+        };
+
+        ~text_index();
+
+        bool open(const std::string &path);
+        void close();
+
+        progress snapshot() const;
+
+        // Line i without its line break, cut at max_bytes.
+        std::string line(std::size_t i, std::size_t max_bytes) const;
+
+        // Appends the start offset of every line that begins after a
+        // newline in p[0, n), where p is at base in the file.
+        static void scan(const char *p, std::size_t n, uint64_t base, std::vector<uint64_t> &starts);
+
+    private:
+        static constexpr std::size_t chunk_bytes = 4u << 20;
+        static constexpr int poll_ms = 250;
+
+        void run();
+        std::size_t lines_locked() const;
+
+        // Drops the index after a truncation. Called with the lock held.
+        void restart();
+
+        mapped_file _file;
+
+        mutable std::mutex _lock;
+        std::condition_variable _wake;
+        std::vector<uint64_t> _starts; // First entry is always 0
+        uint64_t _scanned = 0;
+        uint64_t _generation = 0;
+        bool _stop = false;
+
+        std::thread _worker;
+    };
+}
+}
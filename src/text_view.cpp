@@ -0,0 +1,134 @@
+#include <native.h>
+
+#include "control_paint_backend.h"
+#include "text_index.h"
+
+namespace native
+{
+    // Poll intervals for the index: fast while it is still growing, slow
+    // once only appends are expected.
+    static constexpr uint64_t indexing_ms = 33;
+    static constexpr uint64_t idle_ms = 250;
+
+    // Longest part of a line that is handed to draw_text().
+    static constexpr std::size_t max_line_bytes = 4096;
+
+    text_view::text_view(wnd &w, const rect &bounds)
+        : list_view(w, bounds)
+    {
+        set_source([this] { return _lines; }, nullptr);
+        set_row_height(16);
+    }
+
+    text_view::~text_view()
+    {
+        close();
+    }
+
+    bool text_view::open(const std::string &path)
+    {
+        close();
+
+        auto index = std::make_unique<detail::text_index>();
+        if (!index->open(path))
+            return false;
+
+        _index = std::move(index);
+        _generation = 0;
+        _bytes = 0;
+        schedule(now_ms());
+        return true;
+    }
+
+    void text_view::close()
+    {
+        _index.reset();
+        if (_lines == 0)
+            return;
+
+        _lines = 0;
+        reload();
+    }
+
+    bool text_view::is_open() const
+    {
+        return _index != nullptr;
+    }
+
+    std::size_t text_view::line_count() const
+    {
+        return _index ? _index->snapshot().lines : 0;
+    }
+
+    bool text_view::indexed() const
+    {
+        return _index && _index->snapshot().complete;
+    }
+
+    std::string text_view::line(std::size_t i) const
+    {
+        return _index ? _index->line(i, static_cast<std::size_t>(-1)) : std::string();
+    }
+
+    text_view &text_view::set_follow_tail(bool on)
+    {
+        _follow = on;
+        if (_follow)
+            scroll_to(content_height());
+        return *this;
+    }
+
+    bool text_view::follow_tail() const
+    {
+        return _follow;
+    }
+
+    void text_view::paint_row(gpx &g, std::size_t row, const rect &r, const control_paint::state &st)
+    {
+        const control_paint::palette p = control_paint::native_palette();
+        const bool active = st.selected || st.hot;
+        control_paint(g).draw_menu_item_background(r, st);
+
+        if (!_index)
+            return;
+
+        const rgba old_ink = g.ink();
+        const font_t &old_font = g.font();
+
+        g.set_font(font_t::stock(font_role::fixed));
+        g.set_ink(active ? p.menu_hot_text : p.menu_text);
+        g.draw_text(_index->line(row, max_line_bytes),
+                    point(r.p.x + 4, detail::control_paint_backend_text_y_centered(r)));
+
+        g.set_font(old_font).set_ink(old_ink);
+    }
+
+    // Runs on the main loop. The rows shown only change here, so painting
+    // and hit-testing always see a consistent count.
+    void text_view::deliver(uint64_t now_ms)
+    {
+        if (!_index)
+            return;
+
+        const detail::text_index::progress p = _index->snapshot();
+        const bool changed = p.generation != _generation || p.bytes != _bytes;
+        if (p.generation != _generation)
+        {
+            _generation = p.generation;
+            _lines = p.lines;
+            reload();
+        }
+        else if (changed)
+        {
+            // The last row may have been a partial line that has grown.
+            const std::size_t first = _lines ? _lines - 1 : 0;
+            _lines = p.lines;
+            reload_from(first);
+        }
+        _bytes = p.bytes;
+
+        if (changed && _follow)
+            scroll_to(content_height());
+        schedule(now_ms + (p.complete ? idle_ms : indexing_ms));
+    }
+}
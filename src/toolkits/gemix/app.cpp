@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 #include <gem.h>
 
@@ -20,15 +21,20 @@ namespace
         return native::rect(x, y, static_cast<native::dim>(w), static_cast<native::dim>(h));
     }
 
-    void draw_buttons(native::app_wnd *owner, const native::rect &work)
+    // Draws the buttons that overlap area, in window coordinates.
+    void draw_buttons(native::app_wnd *owner, const native::rect &work, const native::rect &area)
     {
-        for (auto *button : gemix::buttons)
-        {
-            if (!button || !button->parent() || button->parent() != owner)
-                continue;
+        auto *grid = gemix::controls_bindings.from_a(owner);
+        if (!grid)
+            return;
 
+        static std::vector<native::wnd *> hits; // GEM events come from one thread.
+        grid->in(area, hits);
+        for (native::wnd *w : hits)
+        {
+            auto *button = static_cast<native::button *>(w);
             native::gpx_wnd g(owner, native::point(work.p.x, work.p.y));
-            g.set_clip(button->bounds());
+            g.set_clip(button->bounds().intersect(area));
             native::control_paint painter(g);
             painter.draw_button(button->bounds(), button->text());
         }
@@ -54,14 +60,19 @@ namespace
 
             if (piece.w() > 0 && piece.h() > 0)
             {
+                // Each visible piece is painted clipped to itself, in
+                // window coordinates.
+                const native::rect area(static_cast<native::coord>(piece.p.x - work.p.x),
+                                        static_cast<native::coord>(piece.p.y - work.p.y),
+                                        piece.d.w, piece.d.h);
                 native::gpx_wnd g(owner, native::point(work.p.x, work.p.y));
-                g.set_clip(native::rect(0, 0, work.d.w, work.d.h));
+                g.set_clip(area);
                 g.set_paper(native::rgba(0, 0, 0, 255));
                 g.set_ink(native::rgba(255, 255, 255, 255));
                 g.clear(g.paper());
-                native::wnd_paint_event e(native::rect(0, 0, work.d.w, work.d.h), g);
+                native::wnd_paint_event e(area, g);
                 owner->on_wnd_paint.emit(e);
-                draw_buttons(owner, work);
+                draw_buttons(owner, work, area);
                 v_updwk(gemix::runtime.vdi_handle);
             }
 
@@ -73,14 +84,11 @@ namespace
 
     native::button *button_at(native::app_wnd *owner, native::point p)
     {
-        for (auto *button : gemix::buttons)
-        {
-            if (!button || button->parent() != owner)
-                continue;
-            if (button->bounds().contains(p))
-                return button;
-        }
-        return nullptr;
+        auto *grid = gemix::controls_bindings.from_a(owner);
+        if (!grid)
+            return nullptr;
+
+        return static_cast<native::button *>(grid->at(p));
     }
 }
 
@@ -99,6 +107,19 @@ namespace gemix
 
         paint_window(owner, nullptr);
     }
+
+    void repaint_area(native::app_wnd *owner, const native::rect &r)
+    {
+        WORD handle = gemix::wnd_bindings.from_b(owner);
+        if (handle <= 0)
+            return;
+
+        const native::rect work = work_rect_for_handle(handle);
+        const native::rect clip(static_cast<native::coord>(r.p.x + work.p.x),
+                                static_cast<native::coord>(r.p.y + work.p.y),
+                                r.d.w, r.d.h);
+        paint_window(owner, &clip);
+    }
 }
 
 namespace native
@@ -142,8 +163,13 @@ namespace native
             rect work = work_rect_for_handle(handle);
             point local(mx - work.p.x, my - work.p.y);
 
+            // GEM reports only the current pointer state, without a
+            // timestamp, so each poll is its own motion batch.
             if (mx != prev_mx || my != prev_my)
-                main->on_mouse_move.emit(local);
+            {
+                main->on_native_motion(local, 0);
+                main->flush_native_motion();
+            }
 
             if ((prev_mb & 1) == 0 && (mb & 1) != 0)
                 main->on_mouse_click.emit(mouse_event(mouse_button::left, mouse_action::press, local));
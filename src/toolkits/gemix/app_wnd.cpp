@@ -83,6 +83,7 @@ namespace native
             return;
 
         gemix::destroy_menu(const_cast<app_wnd *>(this));
+        gemix::destroy_controls(const_cast<app_wnd *>(this));
 
         WORD handle = gemix::wnd_bindings.from_b(const_cast<app_wnd *>(this));
         if (handle > 0)
@@ -6,6 +6,58 @@
 
 #include "globals.h"
 
+namespace gemix
+{
+    void add_control(native::wnd *w)
+    {
+        native::wnd *p = w->parent();
+        if (!p)
+            return;
+
+        auto *grid = controls_bindings.from_a(p);
+        if (!grid)
+        {
+            grid = new control_grid();
+            controls_bindings.register_pair(p, grid);
+        }
+        grid->place(w, w->bounds());
+    }
+
+    void remove_control(native::wnd *w)
+    {
+        native::wnd *p = w->parent();
+        if (auto *grid = p ? controls_bindings.from_a(p) : nullptr)
+            grid->erase(w);
+    }
+
+    void control_moved(native::wnd *w)
+    {
+        native::wnd *p = w->parent();
+        auto *grid = p ? controls_bindings.from_a(p) : nullptr;
+        if (grid && grid->contains(w))
+            grid->place(w, w->bounds());
+    }
+
+    void control_reparented(native::wnd *w, native::wnd *old_parent)
+    {
+        auto *old = old_parent ? controls_bindings.from_a(old_parent) : nullptr;
+        if (!old || !old->contains(w))
+            return;
+
+        old->erase(w);
+        add_control(w);
+    }
+
+    void destroy_controls(native::wnd *owner)
+    {
+        if (auto *grid = controls_bindings.from_a(owner))
+        {
+            controls_bindings.unregister_by_a(owner);
+            delete grid;
+        }
+    }
+}
+
 namespace native
 {
     button::button(std::string text, coord x, coord y, dim w, dim h)
@@ -31,6 +83,7 @@ namespace native
     button &button::set_text(const std::string &text)
     {
         _text = text;
+        invalidate_measure();
         invalidate();
         return *this;
     }
@@ -44,7 +97,7 @@ namespace native
             throw std::runtime_error("GEMix: button requires a parent.");
 
         _created = true;
-        gemix::buttons.push_back(const_cast<button *>(this));
+        gemix::add_control(const_cast<button *>(this));
         const_cast<button *>(this)->on_wnd_create.emit();
     }
 
@@ -58,10 +111,7 @@ namespace native
         if (!_created)
             return;
 
-        auto *self = const_cast<button *>(this);
-        gemix::buttons.erase(
-            std::remove(gemix::buttons.begin(), gemix::buttons.end(), self),
-            gemix::buttons.end());
+        gemix::remove_control(const_cast<button *>(this));
         _created = false;
     }
 }
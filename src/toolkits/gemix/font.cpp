@@ -45,11 +45,9 @@ namespace native
     const font_t &font_t::stock(font_role role)
     {
         static std::array<font_t, 5> fonts;
-        static bool initialized = false;
+        static std::once_flag once;
 
-        if (!initialized)
-        {
-            initialized = true;
+        std::call_once(once, []() {
             for (auto &font : fonts)
                 font._id = next_font_id();
 
@@ -58,7 +56,7 @@ namespace native
             fonts[static_cast<int>(font_role::title)]._spec.name = "GEM Title";
             fonts[static_cast<int>(font_role::small_)]._spec.name = "GEM Small";
             fonts[static_cast<int>(font_role::control)]._spec.name = "GEM Control";
-        }
+        });
 
         return fonts[static_cast<int>(role)];
     }
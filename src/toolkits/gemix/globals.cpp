@@ -4,7 +4,7 @@ namespace gemix
 {
     runtime_state runtime;
     native::bindings<WORD, native::wnd *> wnd_bindings;
-    std::vector<native::button *> buttons;
+    native::bindings<native::wnd *, control_grid *> controls_bindings;
 
     bool ensure_runtime()
     {
@@ -46,7 +46,7 @@ namespace gemix
         runtime.initialized = false;
         runtime.shutdown_requested = false;
         wnd_bindings.clear();
-        buttons.clear();
+        controls_bindings.clear();
     }
 
     native::rect desktop_rect()
@@ -6,6 +6,7 @@
 
 #include <native.h>
 #include <bindings.h>
+#include <spatial_grid.h>
 
 namespace gemix
 {
@@ -25,13 +26,26 @@ namespace gemix
 
     extern runtime_state runtime;
     extern native::bindings<WORD, native::wnd *> wnd_bindings;
-    extern std::vector<native::button *> buttons;
+
+    // Buttons of each top-level window, indexed by bounds for
+    // hit-testing and for painting only the buttons a redraw touches.
+    using control_grid = native::detail::spatial_grid<native::wnd>;
+    extern native::bindings<native::wnd *, control_grid *> controls_bindings;
 
     bool ensure_runtime();
     void shutdown_runtime();
     native::rect desktop_rect();
     void request_repaint(native::wnd *target);
+    // Repaints r, in window coordinates, of a top-level window.
+    void repaint_area(native::app_wnd *owner, const native::rect &r);
     OBJECT *menu_tree_for(native::app_wnd *owner);
     int menu_item_id_for(native::app_wnd *owner, WORD object_index);
     void destroy_menu(native::app_wnd *owner);
+    // Keep a created button's index entry in step with its bounds and
+    // parent; both ignore windows that are not indexed buttons.
+    void control_moved(native::wnd *w);
+    void control_reparented(native::wnd *w, native::wnd *old_parent);
+    void add_control(native::wnd *w);
+    void remove_control(native::wnd *w);
+    void destroy_controls(native::wnd *owner);
 }
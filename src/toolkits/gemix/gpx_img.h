@@ -1,3 +0,0 @@
-#pragma once
-
-#include "../../gpx_img.h"
@@ -6,8 +6,8 @@
 #include <native.h>
 
 #include "gpx_wnd.h"
-#include "gpx_img.h"
 #include "globals.h"
+#include "scroll.h"
 
 namespace
 {
@@ -145,4 +145,47 @@ namespace native
         vro_cpyfm(gemix::runtime.vdi_handle, S_ONLY, pxy, &src_mfdb, &dst_mfdb);
         return *this;
     }
+
+    gpx &gpx_wnd::copy_area(const rect &src, point dst)
+    {
+        rect s = src;
+        point d = dst;
+        if (!detail::clip_copy(_clip, rect(0, 0, _wnd->dimensions().w, _wnd->dimensions().h), s, d))
+            return *this;
+
+        // Screen to screen; a null fd_addr selects the physical screen.
+        MFDB screen{};
+        WORD pxy[8] = {
+            static_cast<WORD>(s.p.x + _offset.x),
+            static_cast<WORD>(s.p.y + _offset.y),
+            static_cast<WORD>(s.p.x + _offset.x + s.d.w - 1),
+            static_cast<WORD>(s.p.y + _offset.y + s.d.h - 1),
+            static_cast<WORD>(d.x + _offset.x),
+            static_cast<WORD>(d.y + _offset.y),
+            static_cast<WORD>(d.x + _offset.x + s.d.w - 1),
+            static_cast<WORD>(d.y + _offset.y + s.d.h - 1)};
+        vro_cpyfm(gemix::runtime.vdi_handle, S_ONLY, pxy, &screen, &screen);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+    {
+        // v_fillarea() has no winding rule; whole-pixel spans instead.
+        return gpx::fill_path(p, rule);
+    }
+
+    gpx &gpx_wnd::draw_path(const path &p)
+    {
+        return gpx::draw_path(p);
+    }
+
+    gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        return gpx::fill_rect_gradient(r, g);
+    }
+
+    gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        return gpx::fill_rect_pattern(r, tile, origin);
+    }
 }
@@ -0,0 +1,18 @@
+#include "img_text_backend.h"
+
+namespace native
+{
+namespace detail
+{
+    // GEM draws text only through a VDI workstation.
+    bool img_text_backend_draw(const img &,
+                               const rect &,
+                               rgba,
+                               const font_t &,
+                               const std::string &,
+                               point)
+    {
+        return false;
+    }
+}
+}
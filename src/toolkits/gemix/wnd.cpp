@@ -5,6 +5,7 @@
 
 #include "globals.h"
 #include "gpx_wnd.h"
+#include "scroll.h"
 
 namespace
 {
@@ -55,6 +56,8 @@ namespace native
     wnd &wnd::set_position(const point &p)
     {
         _bounds.p = p;
+        if (_created)
+            gemix::control_moved(this);
         if (_parent)
             _parent->invalidate();
         return *this;
@@ -65,6 +68,8 @@ namespace native
         _bounds.d = s;
         if (_layout)
             _layout->relayout(this, layout_bounds_for(this));
+        if (_created)
+            gemix::control_moved(this);
         if (_parent)
             _parent->invalidate();
         return *this;
@@ -75,6 +80,8 @@ namespace native
         _bounds = r;
         if (_layout)
             _layout->relayout(this, layout_bounds_for(this));
+        if (_created)
+            gemix::control_moved(this);
         if (_parent)
             _parent->invalidate();
         return *this;
@@ -136,6 +143,9 @@ namespace native
             }
         }
 
+        if (_created)
+            gemix::control_reparented(this, old_parent);
+
         return *this;
     }
 
@@ -163,4 +173,42 @@ namespace native
 
         return *_gpx;
     }
+
+    namespace detail
+    {
+        bool retain_backend_native(const wnd *)
+        {
+            // Every redraw clears its area before on_wnd_paint runs.
+            return false;
+        }
+
+        bool scroll_backend_native(wnd *w, const rect &r, const scroll_plan &plan)
+        {
+            // Only a top-level window whose whole work area is on screen
+            // can move its pixels; a partly covered one repaints instead.
+            auto *owner = dynamic_cast<app_wnd *>(w);
+            WORD handle = owner && !owner->parent() ? gemix::wnd_bindings.from_b(owner) : 0;
+            if (handle <= 0)
+                return false;
+
+            WORD x = 0, y = 0, ww = 0, wh = 0;
+            wind_get(handle, WF_WORKXYWH, &x, &y, &ww, &wh);
+            GRECT box{};
+            wind_get(handle, WF_FIRSTXYWH, &box.g_x, &box.g_y, &box.g_w, &box.g_h);
+            if (box.g_x != x || box.g_y != y || box.g_w != ww || box.g_h != wh)
+                return false;
+
+            if (plan.src.d.w > 0 && plan.src.d.h > 0)
+            {
+                wind_update(BEG_UPDATE);
+                gpx_wnd g(owner, point(x, y));
+                g.set_clip(r).copy_area(plan.src, plan.dst);
+                wind_update(END_UPDATE);
+            }
+
+            for (int i = 0; i < plan.strip_count; ++i)
+                gemix::repaint_area(owner, plan.strips[i]);
+            return true;
+        }
+    }
 }
@@ -39,7 +39,9 @@ namespace
         if (!owner)
             return;
 
-        owner->on_mouse_move.emit(to_native_point(view, event));
+        owner->on_native_motion(to_native_point(view, event),
+                                static_cast<uint32_t>([event timestamp] * 1000.0));
+        owner->flush_native_motion();
     }
 
     void emit_click(NSView *view, void *owner_ptr, native::mouse_button button, native::mouse_action action, NSEvent *event)
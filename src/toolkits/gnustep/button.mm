@@ -63,6 +63,7 @@ namespace native
     button &button::set_text(const std::string &text)
     {
         _text = text;
+        invalidate_measure();
 
         if (_created)
         {
@@ -95,13 +95,10 @@ font_t font_t::create(const font_spec &spec)
 const font_t &font_t::stock(font_role role)
 {
     static font_t s[5];
-    static bool initialized = false;
-    if (!initialized)
-    {
+    static std::once_flag once;
+    std::call_once(once, []() {
         @autoreleasepool
         {
-            initialized = true;
-
             CGFloat sz       = [NSFont systemFontSize];
             CGFloat sz_small = [NSFont smallSystemFontSize];
 
@@ -116,7 +113,7 @@ const font_t &font_t::stock(font_role role)
             init(font_role::small_,  [NSFont systemFontOfSize:sz_small]);
             init(font_role::control, [NSFont systemFontOfSize:sz]);
         }
-    }
+    });
     return s[(int)role];
 }
 
@@ -208,4 +208,90 @@ gpx &gpx_wnd::draw_img(const img &src, point dst)
     return *this;
 }
 
+gpx &gpx_wnd::copy_area(const rect &, point)
+{
+    // AppKit views keep no pixels between draws that can be moved in
+    // place; wnd::scroll invalidates instead.
+    return *this;
+}
+
+gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+{
+    auto *cache = gnustep::wnd_gpx_bindings.from_a(_wnd);
+    if (!cache || !cache->view)
+        return *this;
+
+    if (![NSGraphicsContext currentContext])
+        return *this;
+
+    [NSGraphicsContext saveGraphicsState];
+    apply_clip(_clip);
+    apply_state(this, cache);
+
+    NSBezierPath *shape = [NSBezierPath bezierPath];
+    [shape setWindingRule:rule == fill_rule::even_odd ? NSEvenOddWindingRule : NSNonZeroWindingRule];
+    const auto &v = p.vertices();
+    for (const auto &c : p.contours())
+    {
+        for (std::size_t i = 0; i < c.count; ++i)
+        {
+            const NSPoint q = NSMakePoint(v[c.first + i].x, v[c.first + i].y);
+            if (i == 0)
+                [shape moveToPoint:q];
+            else
+                [shape lineToPoint:q];
+        }
+        [shape closePath];
+    }
+    [shape fill];
+
+    [NSGraphicsContext restoreGraphicsState];
+    return *this;
+}
+
+gpx &gpx_wnd::draw_path(const path &p)
+{
+    auto *cache = gnustep::wnd_gpx_bindings.from_a(_wnd);
+    if (!cache || !cache->view)
+        return *this;
+
+    if (![NSGraphicsContext currentContext])
+        return *this;
+
+    [NSGraphicsContext saveGraphicsState];
+    apply_clip(_clip);
+    apply_state(this, cache);
+
+    NSBezierPath *shape = [NSBezierPath bezierPath];
+    [shape setLineWidth:pen()];
+    const auto &v = p.vertices();
+    for (const auto &c : p.contours())
+    {
+        for (std::size_t i = 0; i < c.count; ++i)
+        {
+            const NSPoint q = NSMakePoint(v[c.first + i].x, v[c.first + i].y);
+            if (i == 0)
+                [shape moveToPoint:q];
+            else
+                [shape lineToPoint:q];
+        }
+        if (c.closed)
+            [shape closePath];
+    }
+    [shape stroke];
+
+    [NSGraphicsContext restoreGraphicsState];
+    return *this;
+}
+
+gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+{
+    return gpx::fill_rect_gradient(r, g);
+}
+
+gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+{
+    return gpx::fill_rect_pattern(r, tile, origin);
+}
+
 } // namespace native
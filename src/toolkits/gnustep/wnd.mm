@@ -7,6 +7,7 @@
 
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 namespace
 {
@@ -229,4 +230,20 @@ gpx &wnd::get_gpx() const
     return *_gpx;
 }
 
+namespace detail
+{
+    bool retain_backend_native(const wnd *)
+    {
+        // Views are redrawn from scratch in drawRect:.
+        return false;
+    }
+
+    bool scroll_backend_native(wnd *, const rect &, const scroll_plan &)
+    {
+        // Views are redrawn from scratch in drawRect:, so there are no
+        // retained pixels to move.
+        return false;
+    }
+}
+
 } // namespace native
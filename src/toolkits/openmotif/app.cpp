@@ -4,8 +4,19 @@
 
 #include <native.h>
 
+#include "frame_scheduler.h"
 #include "globals.h"
 
+namespace
+{
+    XtIntervalId frame_timer = 0;
+
+    void on_frame_timer(XtPointer, XtIntervalId *)
+    {
+        frame_timer = 0;
+    }
+}
+
 namespace native
 {
 
@@ -18,9 +29,33 @@ namespace native
 
         while (!motif::exit_requested)
         {
-            XEvent event;
-            XtAppNextEvent(motif::app_instance, &event);
-            XtDispatchEvent(&event);
+            // Paint once the queue is drained, just before the loop blocks.
+            // A timeout wakes Xt when the next frame or signal adapter is
+            // due; it is re-armed because the deadline may have moved.
+            if (!XtAppPending(motif::app_instance))
+            {
+                detail::frames().run(motif::paint_wnd);
+
+                if (frame_timer)
+                {
+                    XtRemoveTimeOut(frame_timer);
+                    frame_timer = 0;
+                }
+
+                const int wait = detail::frames().wait_ms();
+                if (wait >= 0)
+                    frame_timer = XtAppAddTimeOut(motif::app_instance,
+                                                  static_cast<unsigned long>(wait),
+                                                  on_frame_timer, nullptr);
+            }
+
+            XtAppProcessEvent(motif::app_instance, XtIMAll);
+        }
+
+        if (frame_timer)
+        {
+            XtRemoveTimeOut(frame_timer);
+            frame_timer = 0;
         }
 
         motif::wnd_bindings.clear();
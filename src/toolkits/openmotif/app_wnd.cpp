@@ -9,6 +9,7 @@
 
 #include <native.h>
 
+#include "frame_scheduler.h"
 #include "globals.h"
 
 namespace
@@ -36,8 +37,9 @@ namespace
         if (cache->backbuffer && cache->buf_w == width && cache->buf_h == height)
             return;
 
-        if (cache->backbuffer)
-            XFreePixmap(motif::cached_display, cache->backbuffer);
+        Pixmap old = cache->backbuffer;
+        const int old_w = cache->buf_w;
+        const int old_h = cache->buf_h;
 
         cache->backbuffer = XCreatePixmap(
             motif::cached_display,
@@ -47,6 +49,38 @@ namespace
             DefaultDepthOfScreen(XtScreen(canvas)));
         cache->buf_w = width;
         cache->buf_h = height;
+
+        if (!old)
+            return;
+
+        // Preserved contents survive the resize; only the newly uncovered
+        // strips are damaged.
+        if (owner->preserve_contents() && cache->valid && cache->gc)
+        {
+            Pixel background = WhitePixelOfScreen(XtScreen(canvas));
+            XtVaGetValues(canvas, XmNbackground, &background, nullptr);
+            XSetForeground(motif::cached_display, cache->gc, background);
+            XFillRectangle(motif::cached_display, cache->backbuffer, cache->gc,
+                           0, 0, static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+            cache->current_fg = owner->get_gpx().paper();
+            XCopyArea(motif::cached_display, old, cache->backbuffer, cache->gc,
+                      0, 0, static_cast<unsigned int>(old_w), static_cast<unsigned int>(old_h), 0, 0);
+
+            if (width > old_w)
+                native::detail::frames().request(owner, native::rect(
+                    static_cast<native::coord>(old_w), 0,
+                    static_cast<native::dim>(width - old_w), static_cast<native::dim>(height)));
+            if (height > old_h)
+                native::detail::frames().request(owner, native::rect(
+                    0, static_cast<native::coord>(old_h),
+                    static_cast<native::dim>(width), static_cast<native::dim>(height - old_h)));
+        }
+        else
+        {
+            cache->valid = false;
+        }
+
+        XFreePixmap(motif::cached_display, old);
     }
 
     void handle_canvas_event(Widget widget, XtPointer client_data, XEvent *event, Boolean *)
@@ -59,50 +93,23 @@ namespace
         {
         case Expose:
         {
-            if (event->xexpose.count != 0)
-                return;
-
-            auto &g = owner->get_gpx();
+            // A retained or cached backbuffer already holds the exposed
+            // pixels.
             auto *cache = motif::wnd_gpx_bindings.from_a(owner);
-
-            int width = 0;
-            int height = 0;
-            if (cache)
-            {
-                width = cache->buf_w;
-                height = cache->buf_h;
-            }
-
-            if (width <= 0 || height <= 0)
+            if ((owner->preserve_contents() || owner->cached()) && cache && cache->valid)
             {
-                Dimension w = 0;
-                Dimension h = 0;
-                XtVaGetValues(widget, XmNwidth, &w, XmNheight, &h, nullptr);
-                width = static_cast<int>(w);
-                height = static_cast<int>(h);
+                native::detail::frames().present(owner, native::rect(
+                    static_cast<native::coord>(event->xexpose.x),
+                    static_cast<native::coord>(event->xexpose.y),
+                    static_cast<native::dim>(event->xexpose.width),
+                    static_cast<native::dim>(event->xexpose.height)));
+                break;
             }
 
-            native::rect r(0, 0, static_cast<native::dim>(width), static_cast<native::dim>(height));
-            g.set_clip(r);
-            g.clear(g.paper());
-
-            native::wnd_paint_event paint_event(r, g);
-            owner->on_wnd_paint.emit(paint_event);
-
-            cache = motif::wnd_gpx_bindings.from_a(owner);
-            if (cache && cache->gc && cache->backbuffer)
-            {
-                XCopyArea(
-                    motif::cached_display,
-                    cache->backbuffer,
-                    XtWindow(widget),
-                    cache->gc,
-                    0, 0,
-                    static_cast<unsigned int>(cache->buf_w),
-                    static_cast<unsigned int>(cache->buf_h),
-                    0, 0);
-                XFlush(motif::cached_display);
-            }
+            // Repaint is deferred to the frame scheduler, which folds
+            // every Expose and invalidate() of this tick into one paint.
+            if (event->xexpose.count == 0)
+                native::detail::frames().request(owner);
             break;
         }
 
@@ -115,15 +122,38 @@ namespace
             if (cache)
                 ensure_backbuffer(owner, widget, width, height);
 
+            // Children moved by the layout or by resize handlers are
+            // configured together, with one flush.
             native::size s(static_cast<native::dim>(width), static_cast<native::dim>(height));
+            native::app::begin_update();
             owner->on_native_resize(s);
             owner->on_wnd_resize.emit(s);
+            native::app::end_update();
             break;
         }
 
         case MotionNotify:
-            owner->on_mouse_move.emit(native::point(event->xmotion.x, event->xmotion.y));
+        {
+            // Fold consecutive queued motion for the canvas into one
+            // on_mouse_move, as the X11 backend does.
+            owner->on_native_motion(native::point(event->xmotion.x, event->xmotion.y),
+                                    static_cast<uint32_t>(event->xmotion.time));
+
+            XEvent next;
+            while (XEventsQueued(motif::cached_display, QueuedAlready) > 0)
+            {
+                XPeekEvent(motif::cached_display, &next);
+                if (next.type != MotionNotify || next.xany.window != event->xany.window)
+                    break;
+
+                XNextEvent(motif::cached_display, &next);
+                owner->on_native_motion(native::point(next.xmotion.x, next.xmotion.y),
+                                        static_cast<uint32_t>(next.xmotion.time));
+            }
+
+            owner->flush_native_motion();
             break;
+        }
 
         case ButtonPress:
         case ButtonRelease:
@@ -173,6 +203,89 @@ namespace
     }
 } // namespace
 
+namespace motif
+{
+    void paint_wnd(native::wnd *owner, const native::rect &damage, const native::rect &exposed)
+    {
+        Widget widget = wnd_bindings.from_b(owner);
+        if (!widget || !XtIsRealized(widget))
+            return;
+
+        auto &g = owner->get_gpx();
+        auto *cache = wnd_gpx_bindings.from_a(owner);
+
+        int width = 0;
+        int height = 0;
+        if (cache)
+        {
+            width = cache->buf_w;
+            height = cache->buf_h;
+        }
+
+        if (width <= 0 || height <= 0)
+        {
+            Dimension w = 0;
+            Dimension h = 0;
+            XtVaGetValues(widget, XmNwidth, &w, XmNheight, &h, nullptr);
+            width = static_cast<int>(w);
+            height = static_cast<int>(h);
+        }
+
+        const native::rect full(0, 0, static_cast<native::dim>(width), static_cast<native::dim>(height));
+        native::rect r = full;
+        native::rect shown = full;
+        const bool preserve = owner->preserve_contents() && cache && cache->gc && cache->backbuffer;
+        if (preserve)
+        {
+            // Only the damaged area is painted, over the retained
+            // contents, with the GC clipped to it.
+            r = full.intersect(damage);
+            shown = full.intersect(exposed);
+            if (r.d.w > 0 && r.d.h > 0)
+            {
+                XRectangle xr{r.p.x, r.p.y, r.d.w, r.d.h};
+                XSetClipRectangles(cached_display, cache->gc, 0, 0, &xr, 1, Unsorted);
+                g.set_clip(r);
+
+                native::wnd_paint_event paint_event(r, g);
+                owner->on_wnd_paint.emit(paint_event);
+
+                XSetClipMask(cached_display, cache->gc, None);
+                g.set_clip(full);
+            }
+        }
+        else if (owner->cached() && cache && cache->valid && damage.d.w == 0)
+        {
+            // Nothing damaged: the cached backbuffer is shown again.
+            shown = full.intersect(exposed);
+        }
+        else
+        {
+            g.set_clip(r);
+            g.clear(g.paper());
+
+            native::wnd_paint_event paint_event(r, g);
+            owner->on_wnd_paint.emit(paint_event);
+        }
+
+        cache = wnd_gpx_bindings.from_a(owner);
+        if (cache && cache->gc && cache->backbuffer && shown.d.w > 0 && shown.d.h > 0)
+        {
+            XCopyArea(
+                cached_display,
+                cache->backbuffer,
+                XtWindow(widget),
+                cache->gc,
+                shown.p.x, shown.p.y,
+                static_cast<unsigned int>(shown.d.w),
+                static_cast<unsigned int>(shown.d.h),
+                shown.p.x, shown.p.y);
+            XFlush(cached_display);
+            cache->valid = true;
+        }
+    }
+} // namespace motif
+
 namespace native
 {
     app_wnd::app_wnd(std::string title, coord x, coord y, dim w, dim h)
@@ -98,13 +98,10 @@ font_t font_t::create(const font_spec &spec)
 const font_t &font_t::stock(font_role role)
 {
     static font_t s[5];
-    static bool initialized = false;
-    if (!initialized)
-    {
-        initialized = true;
-
+    static std::once_flag once;
+    std::call_once(once, []() {
         Display *display = motif::cached_display;
-        if (!display) return s[(int)role];
+        if (!display) return;
 
         const char *x_font = XGetDefault(display, "*", "font");
         Font system_f = x_font ? XLoadFont(display, x_font) : 0;
@@ -131,7 +128,7 @@ const font_t &font_t::stock(font_role role)
         s[(int)font_role::title]._spec.name   = s[(int)font_role::system]._spec.name;
         s[(int)font_role::small_]._spec.name  = s[(int)font_role::system]._spec.name;
         s[(int)font_role::control]._spec.name = s[(int)font_role::system]._spec.name;
-    }
+    });
     return s[(int)role];
 }
 
@@ -23,8 +23,13 @@ namespace motif
         int buf_w = 0;
         int buf_h = 0;
 
+        // Backbuffer holds painted content; with preserve_contents() an
+        // Expose is then served by a blit instead of a repaint.
+        bool valid = false;
+
         native::rgba current_fg = 0xFFFFFFFF;
         int current_thickness = -1;
+        int current_cap = -1;
     } motifgpx;
 
     struct motifmenu {
@@ -50,4 +55,9 @@ namespace motif
     extern native::bindings<native::button *, motifbutton *> button_bindings;
     extern Display *cached_display;
     extern Atom wm_delete_window_atom;
+
+    // Paints a canvas window into its backbuffer and presents it. When
+    // the window preserves its contents only damage is painted and only
+    // exposed is presented.
+    void paint_wnd(native::wnd *owner, const native::rect &damage, const native::rect &exposed);
 }
@@ -1,4 +1,6 @@
+#include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include <Xm/Xm.h>
 #include <X11/Xlib.h>
@@ -8,6 +10,7 @@
 
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 namespace
 {
@@ -61,12 +64,40 @@ namespace
             cache->current_fg = self->ink();
         }
 
-        if (cache->current_thickness != self->pen())
+        if (cache->current_thickness != self->pen() || cache->current_cap != static_cast<int>(self->cap()))
         {
-            XSetLineAttributes(motif::cached_display, cache->gc, self->pen(), LineSolid, CapButt, JoinMiter);
+            const int cap = self->cap() == native::line_cap::round    ? CapRound
+                            : self->cap() == native::line_cap::square ? CapProjecting
+                                                                      : CapButt;
+            XSetLineAttributes(motif::cached_display, cache->gc, self->pen(), LineSolid, cap, JoinMiter);
             cache->current_thickness = self->pen();
+            cache->current_cap = static_cast<int>(self->cap());
         }
     }
+
+    // One polygon for every contour of p. Each contour after the first is
+    // reached from the first vertex and left back to it along the same
+    // seam, so the seams cancel under either fill rule.
+    std::vector<XPoint> path_polygon(const native::path &p)
+    {
+        std::vector<XPoint> points;
+        const auto &v = p.vertices();
+        const auto at = [&](std::size_t i) {
+            return XPoint{static_cast<short>(std::lround(v[i].x)), static_cast<short>(std::lround(v[i].y))};
+        };
+
+        for (const auto &c : p.contours())
+        {
+            if (c.count < 2)
+                continue;
+            for (std::size_t i = 0; i < c.count; ++i)
+                points.push_back(at(c.first + i));
+            points.push_back(at(c.first));
+            if (points.size() > c.count + 1)
+                points.push_back(points.front());
+        }
+        return points;
+    }
 } // namespace
 
 namespace native
@@ -229,8 +260,79 @@ namespace native
             0, 0,
             dst.x, dst.y,
             src.w(), src.h());
+        ximg->data = nullptr; // Still owned by src
         XDestroyImage(ximg);
         return *this;
     }
 
+    gpx &gpx_wnd::copy_area(const rect &src, point dst)
+    {
+        auto *cache = motif::wnd_gpx_bindings.from_a(_wnd);
+        if (!cache || !cache->backbuffer) return *this;
+
+        rect s = src;
+        point d = dst;
+        if (!detail::clip_copy(_clip, rect(0, 0, cache->buf_w, cache->buf_h), s, d))
+            return *this;
+
+        // XCopyArea handles overlapping source and destination itself.
+        XCopyArea(motif::cached_display, cache->backbuffer, cache->backbuffer, cache->gc,
+                  s.p.x, s.p.y, s.d.w, s.d.h, d.x, d.y);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+    {
+        auto *cache = motif::wnd_gpx_bindings.from_a(_wnd);
+        Widget canvas = motif::wnd_bindings.from_b(_wnd);
+        if (!cache || !cache->backbuffer || !canvas)
+            return *this;
+
+        std::vector<XPoint> points = path_polygon(p);
+        if (points.size() < 3)
+            return *this;
+
+        apply_gc(canvas, this, cache);
+        XSetFillRule(motif::cached_display, cache->gc, rule == fill_rule::even_odd ? EvenOddRule : WindingRule);
+        XFillPolygon(motif::cached_display, cache->backbuffer, cache->gc,
+                     points.data(), static_cast<int>(points.size()), Complex, CoordModeOrigin);
+        return *this;
+    }
+
+    gpx &gpx_wnd::draw_path(const path &p)
+    {
+        auto *cache = motif::wnd_gpx_bindings.from_a(_wnd);
+        Widget canvas = motif::wnd_bindings.from_b(_wnd);
+        if (!cache || !cache->backbuffer || !canvas)
+            return *this;
+
+        apply_gc(canvas, this, cache);
+
+        std::vector<XPoint> points;
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            points.clear();
+            for (std::size_t i = 0; i < c.count; ++i)
+                points.push_back(XPoint{static_cast<short>(std::lround(v[c.first + i].x)),
+                                        static_cast<short>(std::lround(v[c.first + i].y))});
+            if (c.closed && c.count > 2)
+                points.push_back(points.front());
+            if (points.size() > 1)
+                XDrawLines(motif::cached_display, cache->backbuffer, cache->gc,
+                           points.data(), static_cast<int>(points.size()), CoordModeOrigin);
+        }
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        return gpx::fill_rect_gradient(r, g);
+    }
+
+    gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        return gpx::fill_rect_pattern(r, tile, origin);
+    }
+
 } // namespace native
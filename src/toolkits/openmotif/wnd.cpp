@@ -6,15 +6,46 @@
 
 #include <native.h>
 
+#include "frame_scheduler.h"
+#include "layout_queue.h"
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 namespace
 {
-    native::rect layout_bounds_for(native::wnd *w)
+    // Deferred geometry for open layout transactions. A child widget is
+    // placed directly, as its parent's geometry manager would place it,
+    // instead of going through a geometry request of its own.
+    void apply_geometry(native::wnd *w)
     {
-        native::size d = w->dimensions();
-        return native::rect(0, 0, d.w, d.h);
+        const native::rect r = w->bounds();
+        Widget shell = motif::shell_bindings.from_b(w);
+        Widget widget = motif::wnd_bindings.from_b(w);
+
+        if (shell)
+        {
+            XtVaSetValues(
+                shell,
+                XtNx, r.p.x,
+                XtNy, r.p.y,
+                XtNwidth, r.d.w,
+                XtNheight, r.d.h,
+                nullptr);
+            if (widget)
+                XtVaSetValues(widget, XmNwidth, r.d.w, XmNheight, r.d.h, nullptr);
+        }
+        else if (widget)
+        {
+            Dimension border = 0;
+            XtVaGetValues(widget, XmNborderWidth, &border, nullptr);
+            XtConfigureWidget(widget, r.p.x, r.p.y, r.d.w, r.d.h, border);
+        }
+    }
+
+    void flush_display()
+    {
+        XFlush(motif::cached_display);
     }
 }
 
@@ -55,6 +86,9 @@ namespace native
             motif::wnd_bindings.unregister_by_b(this);
             motif::shell_bindings.unregister_by_b(this);
         }
+
+        detail::frames().cancel(this);
+        detail::layouts().cancel(this);
     }
 
     point wnd::position() const
@@ -64,9 +98,14 @@ namespace native
 
     wnd &wnd::set_position(const point &p)
     {
+        const rect old = _bounds;
         _bounds.p = p;
 
-        if (_created)
+        if (_created && detail::layouts().deferring())
+        {
+            detail::layouts().move(this, old, apply_geometry, flush_display);
+        }
+        else if (_created)
         {
             Widget shell = motif::shell_bindings.from_b(this);
             if (shell)
@@ -83,9 +122,14 @@ namespace native
 
     wnd &wnd::set_dimensions(const size &s)
     {
+        const rect old = _bounds;
         _bounds.d = s;
 
-        if (_created)
+        if (_created && detail::layouts().deferring())
+        {
+            detail::layouts().move(this, old, apply_geometry, flush_display);
+        }
+        else if (_created)
         {
             Widget shell = motif::shell_bindings.from_b(this);
             Widget canvas = motif::wnd_bindings.from_b(this);
@@ -95,8 +139,7 @@ namespace native
                 XtVaSetValues(canvas, XmNwidth, s.w, XmNheight, s.h, nullptr);
         }
 
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
 
         return *this;
     }
@@ -108,9 +151,14 @@ namespace native
 
     wnd &wnd::set_bounds(const rect &r)
     {
+        const rect old = _bounds;
         _bounds = r;
 
-        if (_created)
+        if (_created && detail::layouts().deferring())
+        {
+            detail::layouts().move(this, old, apply_geometry, flush_display);
+        }
+        else if (_created)
         {
             Widget shell = motif::shell_bindings.from_b(this);
             Widget canvas = motif::wnd_bindings.from_b(this);
@@ -130,8 +178,7 @@ namespace native
                 XtVaSetValues(canvas, XmNwidth, r.d.w, XmNheight, r.d.h, nullptr);
         }
 
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
 
         return *this;
     }
@@ -139,8 +186,7 @@ namespace native
     void wnd::on_native_resize(const size &s)
     {
         _bounds.d = s;
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
     }
 
     void wnd::set_layout(std::unique_ptr<layout_manager> layout)
@@ -150,7 +196,7 @@ namespace native
         {
             for (auto *child : _children)
                 _layout->add_child(child);
-            _layout->relayout(this, layout_bounds_for(this));
+            relayout();
         }
     }
 
@@ -174,7 +220,7 @@ namespace native
             if (old_parent->_layout)
             {
                 old_parent->_layout->remove_child(this);
-                old_parent->_layout->relayout(old_parent, layout_bounds_for(old_parent));
+                old_parent->relayout();
             }
         }
 
@@ -188,7 +234,7 @@ namespace native
             if (_parent->_layout)
             {
                 _parent->_layout->add_child(this);
-                _parent->_layout->relayout(_parent, layout_bounds_for(_parent));
+                _parent->relayout();
             }
         }
 
@@ -205,28 +251,15 @@ namespace native
         if (!_created)
             return const_cast<wnd &>(*this);
 
-        Widget canvas = motif::wnd_bindings.from_b(const_cast<wnd *>(this));
-        if (canvas && XtIsRealized(canvas))
-        {
-            XClearArea(motif::cached_display, XtWindow(canvas), 0, 0, 0, 0, True);
-            XFlush(motif::cached_display);
-        }
-
+        detail::frames().request(this);
         return const_cast<wnd &>(*this);
     }
 
     wnd &wnd::invalidate(const rect &r) const
     {
-        if (!_created)
-            return const_cast<wnd &>(*this);
-
-        Widget canvas = motif::wnd_bindings.from_b(const_cast<wnd *>(this));
-        if (canvas && XtIsRealized(canvas))
-        {
-            XClearArea(motif::cached_display, XtWindow(canvas), r.p.x, r.p.y, r.d.w, r.d.h, True);
-            XFlush(motif::cached_display);
-        }
-
+        // Without preserve_contents() the backbuffer is repainted whole.
+        if (_created)
+            detail::frames().request(this, r);
         return const_cast<wnd &>(*this);
     }
 
@@ -241,4 +274,27 @@ namespace native
         return *_gpx;
     }
 
+
+    namespace detail
+    {
+        bool retain_backend_native(const wnd *)
+        {
+            // The backbuffer is kept between paints, so preserve_contents()
+            // is honoured.
+            return true;
+        }
+
+        bool scroll_backend_native(wnd *w, const rect &r, const scroll_plan &plan)
+        {
+            // Without retained contents the backbuffer is repainted whole
+            // anyway, so there is nothing worth moving.
+            auto *cache = motif::wnd_gpx_bindings.from_a(w);
+            if (!w->preserve_contents() || !cache || !cache->valid)
+                return false;
+
+            scroll_retained(w, r, plan);
+            return true;
+        }
+    }
+
 } // namespace native
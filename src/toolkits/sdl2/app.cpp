@@ -2,50 +2,146 @@
 #include <bindings.h>
 #include <SDL2/SDL.h>
 
+#include "frame_scheduler.h"
 #include "globals.h"
 
 namespace native
 {
-    static void render_window_if_needed(native::wnd *wnd)
+    // Creates or resizes the retained render target of a preserving or
+    // cached window. Contents survive a resize; the uncovered strips are added
+    // to damage.
+    static bool ensure_target(sdl::sdl2gpx *cache, int w, int h, rect &damage)
     {
-        if (!wnd)
-            return;
+        if (cache->target && cache->target_w == w && cache->target_h == h)
+            return true;
+
+        SDL_Texture *target = SDL_CreateTexture(cache->renderer,
+                                                SDL_PIXELFORMAT_RGBA8888,
+                                                SDL_TEXTUREACCESS_TARGET,
+                                                w, h);
+        if (!target)
+            return false;
+
+        SDL_SetRenderTarget(cache->renderer, target);
+        SDL_RenderSetClipRect(cache->renderer, nullptr);
+        SDL_SetRenderDrawColor(cache->renderer, 255, 255, 255, 255);
+        SDL_RenderClear(cache->renderer);
+        cache->current_fg = rgba(255, 255, 255, 255);
+
+        if (cache->target)
+        {
+            SDL_Rect old = {0, 0, cache->target_w, cache->target_h};
+            SDL_RenderCopy(cache->renderer, cache->target, nullptr, &old);
+            SDL_DestroyTexture(cache->target);
+
+            if (w > cache->target_w)
+                damage = detail::unite(damage, rect(static_cast<coord>(cache->target_w), 0,
+                                                    static_cast<dim>(w - cache->target_w),
+                                                    static_cast<dim>(h)));
+            if (h > cache->target_h)
+                damage = detail::unite(damage, rect(0, static_cast<coord>(cache->target_h),
+                                                    static_cast<dim>(w),
+                                                    static_cast<dim>(h - cache->target_h)));
+        }
+        else
+        {
+            damage = rect(0, 0, static_cast<dim>(w), static_cast<dim>(h));
+        }
+
+        SDL_SetRenderTarget(cache->renderer, nullptr);
+        cache->target = target;
+        cache->target_w = w;
+        cache->target_h = h;
+        return true;
+    }
 
+    // The target texture is always copied whole, so exposed is not needed.
+    static void render_window(native::wnd *wnd, const rect &damage, const rect &)
+    {
         SDL_Window *sdl_win = sdl::wnd_bindings.from_b(wnd);
         if (!sdl_win)
             return;
 
-        auto *cache = sdl::wnd_gpx_bindings.from_a(wnd);
-        if (cache && !cache->invalidated)
-            return;
-
         int w = 0, h = 0;
         SDL_GetWindowSize(sdl_win, &w, &h);
         rect r(0, 0, static_cast<dim>(w), static_cast<dim>(h));
         auto &g = wnd->get_gpx().set_clip(r);
-        cache = sdl::wnd_gpx_bindings.from_a(wnd);
+        auto *cache = sdl::wnd_gpx_bindings.from_a(wnd);
         if (!cache || !cache->renderer)
             return;
 
-        g.clear(rgba(255, 255, 255, 255));
-        wnd_paint_event pe{r, g};
-        wnd->on_wnd_paint.emit(pe);
-
-        sdl::render_buttons(wnd, g);
+        rect dr = damage;
+        const bool preserve = wnd->preserve_contents();
+        if ((preserve || wnd->cached()) && ensure_target(cache, w, h, dr))
+        {
+            // Paint into the retained target, then compose it under the
+            // buttons and menu. A preserving window paints only the
+            // damage; a cached one repaints whole once anything is
+            // damaged, and not at all for a present.
+            dr = r.intersect(dr);
+            if (dr.d.w > 0 && dr.d.h > 0)
+            {
+                SDL_SetRenderTarget(cache->renderer, cache->target);
+                if (!preserve)
+                {
+                    dr = r;
+                    g.set_clip(r);
+                    g.clear(rgba(255, 255, 255, 255));
+                }
+                g.set_clip(dr);
+                wnd_paint_event pe{dr, g};
+                wnd->on_wnd_paint.emit(pe);
+                SDL_SetRenderTarget(cache->renderer, nullptr);
+                g.set_clip(r);
+            }
 
-        // Render menu bar on top if present
-        if (auto *aw = dynamic_cast<native::app_wnd *>(wnd))
+            SDL_RenderSetClipRect(cache->renderer, nullptr);
+            SDL_RenderCopy(cache->renderer, cache->target, nullptr, nullptr);
+        }
+        else
         {
-            if (aw->menu.id())
+            if (cache->target)
             {
-                auto *sm = sdl::menu_bindings.from_a(aw->menu.id());
-                if (sm)
-                    sdl::render_menu(sm, g, w, h);
+                SDL_DestroyTexture(cache->target);
+                cache->target = nullptr;
             }
+
+            g.clear(rgba(255, 255, 255, 255));
+            wnd_paint_event pe{r, g};
+            wnd->on_wnd_paint.emit(pe);
         }
 
+        sdl::render_buttons(wnd, g);
+
+        // Overlays such as the menu bar go on top.
+        static std::size_t dispatch_hint = 0;
+        if (auto *d = sdl::dispatch_of(wnd, dispatch_hint); d && d->overlay)
+            d->overlay(wnd, g, w, h);
+
         SDL_RenderPresent(cache->renderer);
-        cache->invalidated = false;
+    }
+
+    static int client_width(native::wnd *wnd)
+    {
+        int w = 0;
+        int h = 0;
+        if (SDL_Window *sdl_win = sdl::wnd_bindings.from_b(wnd))
+            SDL_GetWindowSize(sdl_win, &w, &h);
+        return w;
+    }
+
+    // Hover tracking and on_mouse_move for the latest position of a
+    // coalesced motion batch.
+    static void flush_motion(native::wnd *wnd, point p)
+    {
+        static std::size_t dispatch_hint = 0;
+        if (auto *d = sdl::dispatch_of(wnd, dispatch_hint); d && d->motion)
+        {
+            if (d->motion(wnd, p.x, p.y, client_width(wnd)))
+                detail::frames().present(wnd);
+        }
+        sdl::handle_button_motion(wnd, p.x, p.y);
+        wnd->flush_native_motion();
     }
 
     int app::main_loop()
@@ -53,6 +149,18 @@ namespace native
         SDL_Event event;
         bool running = true;
 
+        // Motion is queued while events are polled and delivered once,
+        // before the next non-motion event or when the queue runs dry.
+        native::wnd *motion_wnd = nullptr;
+        point motion_pos;
+
+        // Per-event window lookups; the hints make repeats a slot compare.
+        std::size_t wnd_hint = 0;
+        std::size_t dispatch_hint = 0;
+
+        // The first frame is painted even if no expose event arrives.
+        detail::frames().request(app::main_wnd());
+
         while (running)
         {
             while (SDL_PollEvent(&event))
@@ -64,10 +172,24 @@ namespace native
                     break;
                 }
 
+                if (event.type != SDL_MOUSEMOTION && motion_wnd)
+                {
+                    flush_motion(motion_wnd, motion_pos);
+                    motion_wnd = nullptr;
+                }
+
+                // Render targets lost their contents; repaint them whole.
+                if (event.type == SDL_RENDER_TARGETS_RESET)
+                {
+                    detail::frames().request(app::main_wnd());
+                    continue;
+                }
+
                 native::wnd *wnd = sdl::wnd_bindings.from_a(
                     event.window.windowID
                         ? SDL_GetWindowFromID(event.window.windowID)
-                        : sdl::main_window);
+                        : sdl::main_window,
+                    wnd_hint);
 
                 if (!wnd)
                     continue;
@@ -75,52 +197,25 @@ namespace native
                 switch (event.type)
                 {
                 case SDL_MOUSEMOTION:
-                {
-                    if (auto *aw = dynamic_cast<native::app_wnd *>(wnd))
-                    {
-                        if (aw->menu.id())
-                        {
-                            auto *sm = sdl::menu_bindings.from_a(aw->menu.id());
-                            int win_w = 0;
-                            int win_h = 0;
-                            SDL_Window *menu_sdl_win = sdl::wnd_bindings.from_b(wnd);
-                            if (menu_sdl_win)
-                                SDL_GetWindowSize(menu_sdl_win, &win_w, &win_h);
-                            if (sm && sdl::handle_menu_motion(sm, event.motion.x, event.motion.y, win_w))
-                            {
-                                if (auto *cache = sdl::wnd_gpx_bindings.from_a(wnd))
-                                    cache->invalidated = true;
-                            }
-                        }
-                    }
-                    sdl::handle_button_motion(wnd, event.motion.x, event.motion.y);
-                    wnd->on_mouse_move.emit(point(event.motion.x, event.motion.y));
+                    if (motion_wnd && motion_wnd != wnd)
+                        flush_motion(motion_wnd, motion_pos);
+                    motion_wnd = wnd;
+                    motion_pos = point(event.motion.x, event.motion.y);
+                    wnd->on_native_motion(motion_pos, event.motion.timestamp);
                     break;
-                }
 
                 case SDL_MOUSEBUTTONDOWN:
                 case SDL_MOUSEBUTTONUP:
                 {
-                    auto *cache2 = sdl::wnd_gpx_bindings.from_a(wnd);
-
-                    // Let the menu intercept down events first
+                    // The window's own handler sees presses first.
                     if (event.type == SDL_MOUSEBUTTONDOWN)
                     {
-                        if (auto *aw = dynamic_cast<native::app_wnd *>(wnd))
+                        auto *d = sdl::dispatch_of(wnd, dispatch_hint);
+                        if (d && d->press &&
+                            d->press(wnd, event.button.x, event.button.y, client_width(wnd)))
                         {
-                            if (aw->menu.id())
-                            {
-                                auto *sm = sdl::menu_bindings.from_a(aw->menu.id());
-                                int btn_win_w = 0, btn_win_h = 0;
-                                SDL_Window *btn_sdl_win = sdl::wnd_bindings.from_b(wnd);
-                                if (btn_sdl_win)
-                                    SDL_GetWindowSize(btn_sdl_win, &btn_win_w, &btn_win_h);
-                                if (sm && sdl::handle_menu_click(sm, event.button.x, event.button.y, btn_win_w))
-                                {
-                                    if (cache2) cache2->invalidated = true;
-                                    break;
-                                }
-                            }
+                            detail::frames().present(wnd);
+                            break;
                         }
                     }
 
@@ -131,8 +226,7 @@ namespace native
                             event.type == SDL_MOUSEBUTTONDOWN,
                             event.type == SDL_MOUSEBUTTONUP))
                     {
-                        if (cache2)
-                            cache2->invalidated = true;
+                        detail::frames().present(wnd);
                         break;
                     }
 
@@ -173,14 +267,19 @@ namespace native
                 case SDL_WINDOWEVENT:
                     switch (event.window.event)
                     {
+                    // Retained or cached contents only need a present.
                     case SDL_WINDOWEVENT_EXPOSED:
-                        if (auto *cache = sdl::wnd_gpx_bindings.from_a(wnd))
-                            cache->invalidated = true;
+                        if (wnd->preserve_contents() || wnd->cached())
+                            detail::frames().present(wnd);
+                        else
+                            detail::frames().request(wnd);
                         break;
 
                     case SDL_WINDOWEVENT_RESIZED:
-                        if (auto *cache = sdl::wnd_gpx_bindings.from_a(wnd))
-                            cache->invalidated = true;
+                        if (wnd->preserve_contents())
+                            detail::frames().present(wnd);
+                        else
+                            detail::frames().request(wnd);
                     {
                         size s(event.window.data1, event.window.data2);
                         wnd->on_native_resize(s);
@@ -201,8 +300,17 @@ namespace native
                 }
             }
 
-            render_window_if_needed(app::main_wnd());
-            SDL_Delay(1);
+            if (motion_wnd)
+            {
+                flush_motion(motion_wnd, motion_pos);
+                motion_wnd = nullptr;
+            }
+
+            // Paint once the queue is drained, then block until the next
+            // event or the next frame tick, whichever comes first.
+            detail::frames().run(render_window);
+            if (running)
+                SDL_WaitEventTimeout(nullptr, detail::frames().wait_ms());
         }
 
         SDL_QuitSubSystem(SDL_INIT_VIDEO);
@@ -8,6 +8,35 @@
 
 #include "globals.h"
 
+namespace sdl
+{
+    static sdl2menu *menu_of(native::wnd *w)
+    {
+        auto *aw = static_cast<native::app_wnd *>(w);
+        return aw->menu.id() ? menu_bindings.from_a(aw->menu.id()) : nullptr;
+    }
+
+    static bool app_wnd_press(native::wnd *w, int x, int y, int win_w)
+    {
+        auto *sm = menu_of(w);
+        return sm && handle_menu_click(sm, x, y, win_w);
+    }
+
+    static bool app_wnd_motion(native::wnd *w, int x, int y, int win_w)
+    {
+        auto *sm = menu_of(w);
+        return sm && handle_menu_motion(sm, x, y, win_w);
+    }
+
+    static void app_wnd_overlay(native::wnd *w, native::gpx &g, int win_w, int win_h)
+    {
+        if (auto *sm = menu_of(w))
+            render_menu(sm, g, win_w, win_h);
+    }
+
+    static const dispatch app_wnd_dispatch{app_wnd_press, app_wnd_motion, app_wnd_overlay};
+}
+
 namespace native
 {
     app_wnd::app_wnd(std::string title, coord x, coord y, dim w, dim h)
@@ -74,6 +103,7 @@ namespace native
         sdl::main_window = window;
 
         sdl::wnd_bindings.register_pair(window, const_cast<app_wnd *>(this));
+        sdl::wnd_dispatch.insert(const_cast<app_wnd *>(this), &sdl::app_wnd_dispatch);
 
         _created = true;
 
@@ -103,6 +133,12 @@ namespace native
 
         if (auto *cache = sdl::wnd_gpx_bindings.from_a(self))
         {
+            if (cache->target)
+                SDL_DestroyTexture(cache->target);
+            if (cache->scratch)
+                SDL_DestroyTexture(cache->scratch);
+            for (const auto &g : cache->gradients)
+                SDL_DestroyTexture(g.texture);
             if (cache->renderer)
                 SDL_DestroyRenderer(cache->renderer);
             delete cache;
@@ -115,6 +151,8 @@ namespace native
             SDL_DestroyWindow(window);
             sdl::wnd_bindings.unregister_by_b(self);
         }
+        sdl::wnd_dispatch.erase(self);
+        sdl::destroy_controls(self);
 
         _created = false;
 
@@ -1,20 +1,58 @@
-#include <algorithm>
 #include <stdexcept>
 #include <utility>
-#include <vector>
 
 #include <native.h>
 
+#include "frame_scheduler.h"
 #include "globals.h"
 
 namespace
 {
-    std::vector<native::button *> g_buttons;
-
     bool is_inside(const native::rect &r, int x, int y)
     {
         return x >= r.x1() && y >= r.y1() && x < r.x2() && y < r.y2();
     }
+
+    // Buttons are composed over the window's contents on every present,
+    // so a button that changes only needs its area presented. A retained
+    // or cached window is not painted for it.
+    void present_button(native::wnd *owner, const native::rect &r)
+    {
+        native::detail::frames().present(owner, r);
+    }
+
+    sdl::sdl2button *handle_of(native::wnd *w)
+    {
+        // Only buttons are ever indexed.
+        return sdl::button_bindings.from_a(static_cast<native::button *>(w));
+    }
+
+    // Moves hover to the topmost visible button under (x, y). Only the
+    // previously and newly hovered buttons are touched and presented.
+    bool update_hover(native::wnd *owner, sdl::sdl2controls *c, int x, int y)
+    {
+        native::wnd *now = c->grid.at(native::point(static_cast<native::coord>(x), static_cast<native::coord>(y)),
+                                      [](native::wnd *w) {
+                                          auto *h = handle_of(w);
+                                          return h && h->visible;
+                                      });
+        if (now == c->hovered)
+            return false;
+
+        if (auto *h = c->hovered ? handle_of(c->hovered) : nullptr)
+        {
+            h->hover = false;
+            present_button(owner, h->bounds);
+        }
+        if (now)
+        {
+            auto *h = handle_of(now);
+            h->hover = true;
+            present_button(owner, h->bounds);
+        }
+        c->hovered = now;
+        return true;
+    }
 }
 
 namespace sdl
@@ -24,27 +62,11 @@ namespace sdl
         if (!owner)
             return false;
 
-        bool changed = false;
-
-        for (auto *btn : g_buttons)
-        {
-            auto *h = button_bindings.from_a(btn);
-            if (!h || h->parent != owner || !h->visible)
-                continue;
-
-            h->bounds = btn->bounds();
-            const bool now_hover = is_inside(h->bounds, x, y);
-            if (now_hover != h->hover)
-            {
-                h->hover = now_hover;
-                changed = true;
-            }
-        }
-
-        if (changed)
-            owner->invalidate();
+        auto *c = controls_bindings.from_a(owner);
+        if (!c)
+            return false;
 
-        return changed;
+        return update_hover(owner, c, x, y);
     }
 
     bool handle_button_mouse(native::wnd *owner, int x, int y, bool pressed, bool released)
@@ -52,48 +74,47 @@ namespace sdl
         if (!owner)
             return false;
 
+        auto *c = controls_bindings.from_a(owner);
+        if (!c)
+            return false;
+
         bool consumed = false;
+        update_hover(owner, c, x, y);
 
-        for (auto *btn : g_buttons)
+        if (pressed)
         {
-            auto *h = button_bindings.from_a(btn);
-            if (!h || h->parent != owner || !h->visible)
-                continue;
-
-            h->bounds = btn->bounds();
+            if (auto *h = c->pressed ? handle_of(c->pressed) : nullptr)
+            {
+                h->pressed = false;
+                present_button(owner, h->bounds);
+            }
 
-            if (pressed)
+            c->pressed = c->hovered;
+            if (auto *h = c->pressed ? handle_of(c->pressed) : nullptr)
             {
-                const bool hit = is_inside(h->bounds, x, y);
-                h->hover = hit;
-                if (hit)
-                {
-                    h->pressed = true;
-                    consumed = true;
-                }
-                else
-                {
-                    h->pressed = false;
-                }
+                h->pressed = true;
+                present_button(owner, h->bounds);
             }
+            consumed = c->pressed != nullptr;
+        }
 
-            if (released)
+        if (released && c->pressed)
+        {
+            // on_click may destroy the button, or the window, so it is
+            // taken first and looked up again.
+            native::wnd *w = c->pressed;
+            c->pressed = nullptr;
+            if (auto *h = handle_of(w))
             {
-                const bool was_pressed = h->pressed;
                 h->pressed = false;
-                h->hover = is_inside(h->bounds, x, y);
-
-                if (was_pressed)
-                {
-                    consumed = true;
-                    if (is_inside(h->bounds, x, y))
-                        btn->on_click.emit();
-                }
+                present_button(owner, h->bounds);
             }
-        }
 
-        if (consumed)
-            owner->invalidate();
+            auto *h = handle_of(w);
+            if (h && is_inside(h->bounds, x, y))
+                static_cast<native::button *>(w)->on_click.emit();
+            return true;
+        }
 
         return consumed;
     }
@@ -103,19 +124,79 @@ namespace sdl
         if (!owner)
             return;
 
-        native::control_paint cp(g);
-        for (auto *btn : g_buttons)
-        {
-            auto *h = button_bindings.from_a(btn);
-            if (!h || h->parent != owner || !h->visible)
-                continue;
+        auto *c = controls_bindings.from_a(owner);
+        if (!c)
+            return;
 
-            h->bounds = btn->bounds();
+        native::control_paint cp(g);
+        c->grid.each([&](native::wnd *w) {
+            auto *h = handle_of(w);
+            if (!h || !h->visible)
+                return;
 
             native::control_paint::state st;
             st.hot = h->hover;
             st.pressed = h->pressed;
             cp.draw_button(h->bounds, h->label, st);
+        });
+    }
+
+    void control_moved(native::wnd *w)
+    {
+        native::wnd *p = w->parent();
+        auto *c = p ? controls_bindings.from_a(p) : nullptr;
+        if (!c || !c->grid.contains(w))
+            return;
+
+        if (auto *h = handle_of(w))
+        {
+            present_button(p, h->bounds);
+            h->bounds = w->bounds();
+        }
+        c->grid.place(w, w->bounds());
+        present_button(p, w->bounds());
+    }
+
+    void control_reparented(native::wnd *w, native::wnd *old_parent)
+    {
+        auto *old = old_parent ? controls_bindings.from_a(old_parent) : nullptr;
+        if (!old || !old->grid.contains(w))
+            return;
+
+        old->grid.erase(w);
+        if (old->hovered == w)
+            old->hovered = nullptr;
+        if (old->pressed == w)
+            old->pressed = nullptr;
+        present_button(old_parent, w->bounds());
+
+        auto *h = handle_of(w);
+        if (h)
+        {
+            h->parent = w->parent();
+            h->hover = false;
+            h->pressed = false;
+        }
+
+        if (native::wnd *p = w->parent())
+        {
+            auto *c = controls_bindings.from_a(p);
+            if (!c)
+            {
+                c = new sdl2controls();
+                controls_bindings.register_pair(p, c);
+            }
+            c->grid.place(w, w->bounds());
+            present_button(p, w->bounds());
+        }
+    }
+
+    void destroy_controls(native::wnd *owner)
+    {
+        if (auto *c = controls_bindings.from_a(owner))
+        {
+            controls_bindings.unregister_by_a(owner);
+            delete c;
         }
     }
 } // namespace sdl
@@ -145,6 +226,7 @@ namespace native
     button &button::set_text(const std::string &text)
     {
         _text = text;
+        invalidate_measure();
 
         if (_created)
         {
@@ -153,7 +235,7 @@ namespace native
             {
                 h->label = _text;
                 if (h->parent)
-                    h->parent->invalidate();
+                    present_button(h->parent, h->bounds);
             }
         }
 
@@ -181,7 +263,13 @@ namespace native
         h->visible = false;
         sdl::button_bindings.register_pair(self, h);
 
-        g_buttons.push_back(self);
+        auto *c = sdl::controls_bindings.from_a(p);
+        if (!c)
+        {
+            c = new sdl::sdl2controls();
+            sdl::controls_bindings.register_pair(p, c);
+        }
+        c->grid.place(self, h->bounds);
 
         _created = true;
         self->on_wnd_create.emit();
@@ -200,7 +288,7 @@ namespace native
         h->hover = false;
         h->pressed = false;
         if (h->parent)
-            h->parent->invalidate();
+            present_button(h->parent, h->bounds);
     }
 
     void button::destroy() const
@@ -213,11 +301,17 @@ namespace native
 
         if (h)
         {
-            auto it = std::remove(g_buttons.begin(), g_buttons.end(), self);
-            g_buttons.erase(it, g_buttons.end());
+            if (auto *c = h->parent ? sdl::controls_bindings.from_a(h->parent) : nullptr)
+            {
+                c->grid.erase(self);
+                if (c->hovered == self)
+                    c->hovered = nullptr;
+                if (c->pressed == self)
+                    c->pressed = nullptr;
+            }
 
             if (h->parent)
-                h->parent->invalidate();
+                present_button(h->parent, h->bounds);
 
             sdl::button_bindings.unregister_by_a(self);
             delete h;
@@ -9,7 +9,8 @@
 #include "globals.h"
 
 // font_t on SDL2: the platform handle (sdl2font) owns a TTF_Font and
-// lives in sdl::font_bindings, keyed by the font's opaque uint32_t id.
+// lives in sdl::font_handles. The font's opaque uint32_t id is its
+// generation-checked handle there.
 // When HAVE_SDL2_TTF is not defined, all methods produce invalid font_t
 // objects and draw_text remains a no-op.
 
@@ -24,30 +25,21 @@ namespace
         const char *fallbacks[8];
     };
 
-    uint32_t next_id()
-    {
-        static uint32_t counter = 0;
-        return ++counter;
-    }
-
     void release(uint32_t id)
     {
-        auto *f = sdl::font_bindings.from_a(id);
+        auto *f = sdl::font_handles.release(id);
         if (f)
         {
             TTF_CloseFont(f->ttf_font);
             delete f;
         }
-        sdl::font_bindings.unregister_by_a(id);
     }
 
     uint32_t register_font(TTF_Font *ttf_font)
     {
         auto *h = new sdl::sdl2font();
         h->ttf_font = ttf_font;
-        uint32_t id = next_id();
-        sdl::font_bindings.register_pair(id, h);
-        return id;
+        return sdl::font_handles.insert(h);
     }
 
     // Query the system font path via fontconfig (fc-match).
@@ -150,10 +142,8 @@ font_t font_t::create(const font_spec &spec)
 const font_t &font_t::stock(font_role role)
 {
     static font_t s[5];
-    static bool initialized = false;
-    if (!initialized)
-    {
-        initialized = true;
+    static std::once_flag once;
+    std::call_once(once, []() {
 #ifdef HAVE_SDL2_TTF
         static const stock_font_def defs[] = {
             { font_role::system, 12, { "Roboto", "Noto Sans", "Inter", "Segoe UI", "Helvetica Neue", "Arial", "sans", nullptr } },
@@ -174,7 +164,7 @@ const font_t &font_t::stock(font_role role)
             }
         }
 #endif
-    }
+    });
     return s[(int)role];
 }
 
@@ -12,7 +12,9 @@ namespace sdl
     native::bindings<native::wnd *, sdl2gpx *> wnd_gpx_bindings;
     native::bindings<uint32_t, sdl2menu *> menu_bindings;
     native::bindings<native::button *, sdl2button *> button_bindings;
+    native::bindings<native::wnd *, sdl2controls *> controls_bindings;
+    native::detail::flat_map<native::wnd *, const dispatch *> wnd_dispatch;
 #ifdef HAVE_SDL2_TTF
-    native::bindings<uint32_t, sdl2font *> font_bindings;
+    native::handle_table<sdl2font> font_handles;
 #endif
 }
@@ -7,6 +7,8 @@
 
 #include <native.h>
 #include <bindings.h>
+#include <handle_table.h>
+#include <spatial_grid.h>
 
 namespace sdl
 {
@@ -18,19 +20,40 @@ namespace sdl
     };
 #endif
 
+    // A gradient rendered at one size and kept as a texture.
+    struct sdl2gradient
+    {
+        uint64_t serial;
+        int w;
+        int h;
+        SDL_Texture *texture;
+    };
+
     // Graphics cache structure for SDL2
     typedef struct
     {
         SDL_Renderer *renderer = nullptr; // Cached renderer per window
 
+        // Retained render target for preserve_contents() windows
+        SDL_Texture *target = nullptr;
+        int target_w = 0;
+        int target_h = 0;
+
+        // Scratch texture for copy_area; SDL cannot copy a target onto itself
+        SDL_Texture *scratch = nullptr;
+        int scratch_w = 0;
+        int scratch_h = 0;
+
         // Cached draw parameters
         native::rgba current_fg = 0xFFFFFFFF;
         int current_thickness = -1;
 
+        // Gradients uploaded by fill_rect_gradient, most recent first
+        std::vector<sdl2gradient> gradients;
+
         // Clip region
         native::rect clip = {};
         bool dirty_clip = true;
-        bool invalidated = true;
     } sdl2gpx;
 
     static constexpr int MENU_BAR_H = 24;
@@ -60,6 +83,15 @@ namespace sdl
         bool visible = false;
     };
 
+    // Buttons of one window, indexed by bounds for hit-testing, with the
+    // hovered and pressed ones kept apart so pointer events touch only
+    // those.
+    struct sdl2controls {
+        native::detail::spatial_grid<native::wnd> grid;
+        native::wnd *hovered = nullptr;
+        native::wnd *pressed = nullptr;
+    };
+
     void render_menu(sdl2menu *m, native::gpx &g, int win_w, int win_h);
     // Returns true if the click was consumed by the menu.
     bool handle_menu_click(sdl2menu *m, int x, int y, int win_w);
@@ -67,6 +99,11 @@ namespace sdl
     bool handle_button_mouse(native::wnd *owner, int x, int y, bool pressed, bool released);
     bool handle_button_motion(native::wnd *owner, int x, int y);
     void render_buttons(native::wnd *owner, native::gpx &g);
+    // Keep a created button's index entry in step with its bounds and
+    // parent; both ignore windows that are not indexed buttons.
+    void control_moved(native::wnd *w);
+    void control_reparented(native::wnd *w, native::wnd *old_parent);
+    void destroy_controls(native::wnd *owner);
     int text_width(const std::string &text);
     int text_height();
     void draw_text(SDL_Renderer *r, const std::string &text, int x, int y, SDL_Color col);
@@ -76,7 +113,29 @@ namespace sdl
     extern native::bindings<native::wnd *, sdl2gpx *> wnd_gpx_bindings;
     extern native::bindings<uint32_t, sdl2menu *> menu_bindings;
     extern native::bindings<native::button *, sdl2button *> button_bindings;
+    extern native::bindings<native::wnd *, sdl2controls *> controls_bindings;
 #ifdef HAVE_SDL2_TTF
-    extern native::bindings<uint32_t, sdl2font *> font_bindings;
+    extern native::handle_table<sdl2font> font_handles;
 #endif
+
+    // Per-window dispatch target, chosen once by create(). Every hook is
+    // optional; win_w is the window's client width.
+    struct dispatch
+    {
+        // Pointer press; returns true when the press was consumed.
+        bool (*press)(native::wnd *w, int x, int y, int win_w) = nullptr;
+        // Latest position of a motion batch; returns true when the
+        // window needs presenting.
+        bool (*motion)(native::wnd *w, int x, int y, int win_w) = nullptr;
+        // Draws on top of the window contents and buttons.
+        void (*overlay)(native::wnd *w, native::gpx &g, int win_w, int win_h) = nullptr;
+    };
+
+    extern native::detail::flat_map<native::wnd *, const dispatch *> wnd_dispatch;
+
+    inline const dispatch *dispatch_of(native::wnd *w, std::size_t &hint)
+    {
+        const std::size_t i = wnd_dispatch.find(w, hint);
+        return i != wnd_dispatch.npos ? wnd_dispatch.value(i) : nullptr;
+    }
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <stdexcept>
 #include <cmath>
 
@@ -9,6 +10,7 @@
 #include <native.h>
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 static void apply_sdl_state(SDL_Renderer *renderer, native::gpx_wnd *self, sdl::sdl2gpx *cache)
 {
@@ -43,7 +45,7 @@ namespace native
             throw std::runtime_error("SDL2: No window available for gpx_wnd");
 
         // Get or create renderer
-        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache)
         {
             cache = new sdl::sdl2gpx();
@@ -69,7 +71,7 @@ namespace native
 
     gpx &gpx_wnd::clear(rgba color)
     {
-        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->renderer)
             return *this;
 
@@ -88,7 +90,7 @@ namespace native
 
     gpx &gpx_wnd::draw_line(point from, point to)
     {
-        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->renderer)
             return *this;
 
@@ -101,7 +103,7 @@ namespace native
 
     gpx &gpx_wnd::draw_rect(rect r, bool filled)
     {
-        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->renderer)
             return *this;
 
@@ -119,7 +121,7 @@ namespace native
 
     gpx &gpx_wnd::draw_text(const std::string &text, point p)
     {
-        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->renderer)
             return *this;
 
@@ -134,7 +136,7 @@ namespace native
             return *this;
         }
 
-        auto *fh = sdl::font_bindings.from_a(font().id());
+        auto *fh = sdl::font_handles.get(font().id());
         if (fh && fh->ttf_font)
         {
             SDL_Color color = {ink().r, ink().g, ink().b, ink().a};
@@ -160,7 +162,7 @@ namespace native
 
     gpx &gpx_wnd::draw_img(const img &src, point dst)
     {
-        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->renderer)
             return *this;
 
@@ -189,4 +191,114 @@ namespace native
         return *this;
     }
 
+    gpx &gpx_wnd::copy_area(const rect &src, point dst)
+    {
+        // Only the retained target of a preserving window holds pixels
+        // between frames; the window surface is rebuilt on every present.
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
+        if (!cache || !cache->renderer || !cache->target)
+            return *this;
+
+        rect s = src;
+        point d = dst;
+        if (!detail::clip_copy(_clip, rect(0, 0, cache->target_w, cache->target_h), s, d))
+            return *this;
+
+        SDL_Renderer *renderer = cache->renderer;
+        if (!cache->scratch || cache->scratch_w < cache->target_w || cache->scratch_h < cache->target_h)
+        {
+            if (cache->scratch)
+                SDL_DestroyTexture(cache->scratch);
+            cache->scratch = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                               SDL_TEXTUREACCESS_TARGET,
+                                               cache->target_w, cache->target_h);
+            cache->scratch_w = cache->scratch ? cache->target_w : 0;
+            cache->scratch_h = cache->scratch ? cache->target_h : 0;
+            if (!cache->scratch)
+                return *this;
+        }
+
+        // Bounce through the scratch texture, then restore whichever
+        // target was bound (the window, or the retained target mid-paint)
+        // and its clip, which the copies below reset.
+        SDL_Texture *bound = SDL_GetRenderTarget(renderer);
+        SDL_Rect bound_clip = {0, 0, 0, 0};
+        const bool clipped = SDL_RenderIsClipEnabled(renderer) == SDL_TRUE;
+        SDL_RenderGetClipRect(renderer, &bound_clip);
+        const SDL_Rect from = {s.p.x, s.p.y, static_cast<int>(s.d.w), static_cast<int>(s.d.h)};
+        const SDL_Rect to = {d.x, d.y, from.w, from.h};
+
+        SDL_SetRenderTarget(renderer, cache->scratch);
+        SDL_RenderSetClipRect(renderer, nullptr);
+        SDL_RenderCopy(renderer, cache->target, &from, &from);
+
+        SDL_SetRenderTarget(renderer, cache->target);
+        SDL_RenderSetClipRect(renderer, nullptr);
+        SDL_RenderCopy(renderer, cache->scratch, &from, &to);
+
+        SDL_SetRenderTarget(renderer, bound);
+        SDL_RenderSetClipRect(renderer, clipped ? &bound_clip : nullptr);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+    {
+        // SDL_Renderer has no polygon fill; whole-pixel spans instead.
+        return gpx::fill_path(p, rule);
+    }
+
+    gpx &gpx_wnd::draw_path(const path &p)
+    {
+        return gpx::draw_path(p);
+    }
+
+    gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        auto *cache = sdl::wnd_gpx_bindings.from_a(_wnd, _state_hint);
+        if (!cache || !cache->renderer || r.d.w == 0 || r.d.h == 0)
+            return *this;
+
+        // The same gradients come back at the same sizes paint after
+        // paint, so the last few stay on the GPU as textures.
+        static constexpr std::size_t kept = 8;
+        SDL_Renderer *renderer = cache->renderer;
+        auto &list = cache->gradients;
+        auto it = std::find_if(list.begin(), list.end(), [&](const sdl::sdl2gradient &e) {
+            return e.serial == g.serial() && e.w == r.d.w && e.h == r.d.h;
+        });
+        if (it == list.end())
+        {
+            const img &pixels = g.image(r.d.w, r.d.h);
+            SDL_Surface *surface = SDL_CreateRGBSurfaceFrom(
+                const_cast<rgba *>(pixels.pixels()),
+                pixels.w(), pixels.h(), 32, pixels.w() * 4,
+                0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+            if (!surface)
+                return *this;
+            SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+            SDL_FreeSurface(surface);
+            if (!texture)
+                return *this;
+
+            if (list.size() == kept)
+            {
+                SDL_DestroyTexture(list.back().texture);
+                list.pop_back();
+            }
+            list.insert(list.begin(), sdl::sdl2gradient{g.serial(), r.d.w, r.d.h, texture});
+        }
+        else
+            std::rotate(list.begin(), it, it + 1);
+
+        apply_sdl_state(renderer, this, cache);
+        const SDL_Rect dst_rect = {r.p.x, r.p.y, static_cast<int>(r.d.w), static_cast<int>(r.d.h)};
+        SDL_RenderCopy(renderer, list.front().texture, nullptr, &dst_rect);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        return gpx::fill_rect_pattern(r, tile, origin);
+    }
+
 } // namespace native
@@ -0,0 +1,18 @@
+#include "img_text_backend.h"
+
+namespace native
+{
+namespace detail
+{
+    // SDL2 images have always used the built-in font.
+    bool img_text_backend_draw(const img &,
+                               const rect &,
+                               rgba,
+                               const font_t &,
+                               const std::string &,
+                               point)
+    {
+        return false;
+    }
+}
+}
@@ -1,5 +1,3 @@
-#include <cctype>
-#include <cstring>
 #include <string>
 
 #include <SDL2/SDL.h>
@@ -9,84 +7,14 @@
 
 #include <native.h>
 
+#include "glyphs.h"
 #include "globals.h"
 
 namespace
 {
     constexpr int k_fallback_scale = 1;
-    constexpr int k_glyph_w = 5;
-    constexpr int k_glyph_h = 7;
-
-    bool glyph_rows(char ch, uint8_t rows[k_glyph_h])
-    {
-        std::memset(rows, 0, k_glyph_h);
-
-        if (ch >= 'a' && ch <= 'z')
-            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
-
-        switch (ch)
-        {
-        case 'A': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x11,0x1F,0x11,0x11,0x11}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'B': { uint8_t t[k_glyph_h] = {0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'C': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x10,0x10,0x10,0x11,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'D': { uint8_t t[k_glyph_h] = {0x1C,0x12,0x11,0x11,0x11,0x12,0x1C}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'E': { uint8_t t[k_glyph_h] = {0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'F': { uint8_t t[k_glyph_h] = {0x1F,0x10,0x10,0x1E,0x10,0x10,0x10}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'G': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x10,0x17,0x11,0x11,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'H': { uint8_t t[k_glyph_h] = {0x11,0x11,0x11,0x1F,0x11,0x11,0x11}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'I': { uint8_t t[k_glyph_h] = {0x1F,0x04,0x04,0x04,0x04,0x04,0x1F}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'J': { uint8_t t[k_glyph_h] = {0x1F,0x02,0x02,0x02,0x12,0x12,0x0C}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'K': { uint8_t t[k_glyph_h] = {0x11,0x12,0x14,0x18,0x14,0x12,0x11}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'L': { uint8_t t[k_glyph_h] = {0x10,0x10,0x10,0x10,0x10,0x10,0x1F}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'M': { uint8_t t[k_glyph_h] = {0x11,0x1B,0x15,0x15,0x11,0x11,0x11}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'N': { uint8_t t[k_glyph_h] = {0x11,0x19,0x15,0x13,0x11,0x11,0x11}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'O': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x11,0x11,0x11,0x11,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'P': { uint8_t t[k_glyph_h] = {0x1E,0x11,0x11,0x1E,0x10,0x10,0x10}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'Q': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x11,0x11,0x15,0x12,0x0D}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'R': { uint8_t t[k_glyph_h] = {0x1E,0x11,0x11,0x1E,0x14,0x12,0x11}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'S': { uint8_t t[k_glyph_h] = {0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'T': { uint8_t t[k_glyph_h] = {0x1F,0x04,0x04,0x04,0x04,0x04,0x04}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'U': { uint8_t t[k_glyph_h] = {0x11,0x11,0x11,0x11,0x11,0x11,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'V': { uint8_t t[k_glyph_h] = {0x11,0x11,0x11,0x11,0x11,0x0A,0x04}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'W': { uint8_t t[k_glyph_h] = {0x11,0x11,0x11,0x15,0x15,0x15,0x0A}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'X': { uint8_t t[k_glyph_h] = {0x11,0x11,0x0A,0x04,0x0A,0x11,0x11}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'Y': { uint8_t t[k_glyph_h] = {0x11,0x11,0x0A,0x04,0x04,0x04,0x04}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case 'Z': { uint8_t t[k_glyph_h] = {0x1F,0x01,0x02,0x04,0x08,0x10,0x1F}; std::memcpy(rows,t,k_glyph_h); return true; }
-
-        case '0': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x13,0x15,0x19,0x11,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '1': { uint8_t t[k_glyph_h] = {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '2': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x01,0x02,0x04,0x08,0x1F}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '3': { uint8_t t[k_glyph_h] = {0x1E,0x01,0x01,0x06,0x01,0x01,0x1E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '4': { uint8_t t[k_glyph_h] = {0x02,0x06,0x0A,0x12,0x1F,0x02,0x02}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '5': { uint8_t t[k_glyph_h] = {0x1F,0x10,0x10,0x1E,0x01,0x01,0x1E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '6': { uint8_t t[k_glyph_h] = {0x0E,0x10,0x10,0x1E,0x11,0x11,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '7': { uint8_t t[k_glyph_h] = {0x1F,0x01,0x02,0x04,0x08,0x08,0x08}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '8': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '9': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x11,0x0F,0x01,0x01,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-
-        case ' ': return true;
-        case '.': { uint8_t t[k_glyph_h] = {0x00,0x00,0x00,0x00,0x00,0x0C,0x0C}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case ',': { uint8_t t[k_glyph_h] = {0x00,0x00,0x00,0x00,0x0C,0x0C,0x08}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case ':': { uint8_t t[k_glyph_h] = {0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x00}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case ';': { uint8_t t[k_glyph_h] = {0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x08}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '!': { uint8_t t[k_glyph_h] = {0x04,0x04,0x04,0x04,0x04,0x00,0x04}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '?': { uint8_t t[k_glyph_h] = {0x0E,0x11,0x01,0x02,0x04,0x00,0x04}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '-': { uint8_t t[k_glyph_h] = {0x00,0x00,0x00,0x1F,0x00,0x00,0x00}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '+': { uint8_t t[k_glyph_h] = {0x00,0x04,0x04,0x1F,0x04,0x04,0x00}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '_': { uint8_t t[k_glyph_h] = {0x00,0x00,0x00,0x00,0x00,0x00,0x1F}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '/': { uint8_t t[k_glyph_h] = {0x01,0x02,0x02,0x04,0x08,0x08,0x10}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '(': { uint8_t t[k_glyph_h] = {0x02,0x04,0x08,0x08,0x08,0x04,0x02}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case ')': { uint8_t t[k_glyph_h] = {0x08,0x04,0x02,0x02,0x02,0x04,0x08}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '[': { uint8_t t[k_glyph_h] = {0x0E,0x08,0x08,0x08,0x08,0x08,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case ']': { uint8_t t[k_glyph_h] = {0x0E,0x02,0x02,0x02,0x02,0x02,0x0E}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '#': { uint8_t t[k_glyph_h] = {0x0A,0x0A,0x1F,0x0A,0x1F,0x0A,0x0A}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '\'': { uint8_t t[k_glyph_h] = {0x04,0x04,0x08,0x00,0x00,0x00,0x00}; std::memcpy(rows,t,k_glyph_h); return true; }
-        case '"': { uint8_t t[k_glyph_h] = {0x0A,0x0A,0x00,0x00,0x00,0x00,0x00}; std::memcpy(rows,t,k_glyph_h); return true; }
-
-        default:
-            return false;
-        }
-    }
+    constexpr int k_glyph_w = native::detail::glyph_w;
+    constexpr int k_glyph_h = native::detail::glyph_h;
 
     int fallback_text_width(const std::string &text)
     {
@@ -106,7 +34,7 @@ namespace
         for (std::size_t i = 0; i < text.size(); ++i)
         {
             uint8_t rows[k_glyph_h] = {};
-            bool known = glyph_rows(text[i], rows);
+            bool known = native::detail::glyph_rows(text[i], rows);
 
             if (!known)
             {
@@ -153,7 +81,7 @@ namespace sdl
     int text_width(const std::string &text)
     {
 #ifdef HAVE_SDL2_TTF
-        auto *fh = sdl::font_bindings.from_a(native::font_t::stock(native::font_role::control).id());
+        auto *fh = sdl::font_handles.get(native::font_t::stock(native::font_role::control).id());
         if (fh && fh->ttf_font)
         {
             int w = 0;
@@ -168,7 +96,7 @@ namespace sdl
     int text_height()
     {
 #ifdef HAVE_SDL2_TTF
-        auto *fh = sdl::font_bindings.from_a(native::font_t::stock(native::font_role::control).id());
+        auto *fh = sdl::font_handles.get(native::font_t::stock(native::font_role::control).id());
         if (fh && fh->ttf_font)
             return TTF_FontHeight(fh->ttf_font);
 #endif
@@ -178,7 +106,7 @@ namespace sdl
     void draw_text(SDL_Renderer *r, const std::string &text, int x, int y, SDL_Color col)
     {
 #ifdef HAVE_SDL2_TTF
-        auto *fh = sdl::font_bindings.from_a(native::font_t::stock(native::font_role::control).id());
+        auto *fh = sdl::font_handles.get(native::font_t::stock(native::font_role::control).id());
         if (fh && fh->ttf_font)
         {
             SDL_Surface *surf = TTF_RenderUTF8_Solid(fh->ttf_font, text.c_str(), col);
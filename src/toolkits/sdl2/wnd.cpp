@@ -5,17 +5,11 @@
 
 #include <native.h>
 #include "bindings.h"
+#include "frame_scheduler.h"
+#include "layout_queue.h"
 #include "gpx_wnd.h"
 #include "globals.h"
-
-namespace
-{
-    native::rect layout_bounds_for(native::wnd *w)
-    {
-        native::size d = w->dimensions();
-        return native::rect(0, 0, d.w, d.h);
-    }
-}
+#include "scroll.h"
 
 namespace native
 {
@@ -52,7 +46,11 @@ namespace native
         if (_created)
         {
             sdl::wnd_bindings.unregister_by_b(this);
+            sdl::wnd_dispatch.erase(this);
         }
+
+        detail::frames().cancel(this);
+        detail::layouts().cancel(this);
     }
 
     point wnd::position() const
@@ -68,6 +66,7 @@ namespace native
         {
             SDL_Window *win = sdl::wnd_bindings.from_b(this);
             SDL_SetWindowPosition(win, p.x, p.y);
+            sdl::control_moved(this);
         }
 
         return *this;
@@ -86,10 +85,10 @@ namespace native
         {
             SDL_Window *win = sdl::wnd_bindings.from_b(this);
             SDL_SetWindowSize(win, s.w, s.h);
+            sdl::control_moved(this);
         }
 
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
 
         return *this;
     }
@@ -108,10 +107,10 @@ namespace native
             SDL_Window *win = sdl::wnd_bindings.from_b(this);
             SDL_SetWindowPosition(win, r.p.x, r.p.y);
             SDL_SetWindowSize(win, r.d.w, r.d.h);
+            sdl::control_moved(this);
         }
 
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
 
         return *this;
     }
@@ -119,8 +118,7 @@ namespace native
     void wnd::on_native_resize(const size &s)
     {
         _bounds.d = s;
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
     }
 
     void wnd::set_layout(std::unique_ptr<layout_manager> layout)
@@ -130,7 +128,7 @@ namespace native
         {
             for (auto *child : _children)
                 _layout->add_child(child);
-            _layout->relayout(this, layout_bounds_for(this));
+            relayout();
         }
     }
 
@@ -154,7 +152,7 @@ namespace native
             if (old_parent->_layout)
             {
                 old_parent->_layout->remove_child(this);
-                old_parent->_layout->relayout(old_parent, layout_bounds_for(old_parent));
+                old_parent->relayout();
             }
         }
 
@@ -172,10 +170,13 @@ namespace native
             if (_parent->_layout)
             {
                 _parent->_layout->add_child(this);
-                _parent->_layout->relayout(_parent, layout_bounds_for(_parent));
+                _parent->relayout();
             }
         }
 
+        if (_created)
+            sdl::control_reparented(this, old_parent);
+
         return *this;
     }
 
@@ -189,17 +190,17 @@ namespace native
         if (!_created)
             return const_cast<wnd &>(*this);
 
-        if (auto *cache = sdl::wnd_gpx_bindings.from_a(const_cast<wnd *>(this)))
-            cache->invalidated = true;
+        detail::frames().request(this);
 
         return const_cast<wnd &>(*this);
     }
 
     wnd &wnd::invalidate(const rect &r) const
     {
-        // SDL2 doesn't support partial invalidation natively
-        // Just invalidate the whole window
-        return invalidate();
+        // Without preserve_contents() the window is repainted whole.
+        if (_created)
+            detail::frames().request(this, r);
+        return const_cast<wnd &>(*this);
     }
 
     gpx &wnd::get_gpx() const
@@ -213,4 +214,26 @@ namespace native
         return *_gpx;
     }
 
+
+    namespace detail
+    {
+        bool retain_backend_native(const wnd *)
+        {
+            // The backbuffer is kept between paints, so preserve_contents()
+            // is honoured.
+            return true;
+        }
+
+        bool scroll_backend_native(wnd *w, const rect &r, const scroll_plan &plan)
+        {
+            // The retained target is the only surface that outlives a frame.
+            auto *cache = sdl::wnd_gpx_bindings.from_a(w);
+            if (!w->preserve_contents() || !cache || !cache->target)
+                return false;
+
+            scroll_retained(w, r, plan);
+            return true;
+        }
+    }
+
 } // namespace native
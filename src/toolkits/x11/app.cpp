@@ -1,14 +1,110 @@
 #include <stdexcept>
 
+#include <poll.h>
 #include <X11/Xlib.h>
 
 #include <native.h>
 #include <bindings.h>
 
+#include "frame_scheduler.h"
 #include "globals.h"
 
 namespace native
 {
+    static void present(Window win, x11::x11gpx *cache, const rect &r)
+    {
+        XCopyArea(x11::cached_display,
+                  cache->backbuffer, win, cache->gc,
+                  r.p.x, r.p.y, r.d.w, r.d.h,
+                  r.p.x, r.p.y);
+        XFlush(x11::cached_display);
+    }
+
+    static void paint_window(native::wnd *wnd, const rect &damage, const rect &exposed)
+    {
+        static std::size_t dispatch_hint = 0;
+        if (auto *d = x11::dispatch_of(wnd, dispatch_hint); d && d->paint)
+        {
+            d->paint(wnd);
+            return;
+        }
+
+        Window win = x11::wnd_bindings.from_b(wnd);
+        if (!win)
+            return;
+
+        auto &g = wnd->get_gpx();
+        auto *cache = x11::wnd_gpx_bindings.from_a(wnd);
+        rect r(0, 0,
+               cache ? cache->buf_w : 0,
+               cache ? cache->buf_h : 0);
+
+        if (wnd->preserve_contents() && cache && cache->backbuffer)
+        {
+            // Only the damaged area is painted, over the retained
+            // contents. The GC clip keeps stray drawing out of the
+            // backbuffer and is dropped again before the blit.
+            const rect full = r;
+            r = full.intersect(damage);
+            if (r.d.w > 0 && r.d.h > 0)
+            {
+                XRectangle xr{r.p.x, r.p.y, r.d.w, r.d.h};
+                XSetClipRectangles(x11::cached_display, cache->gc, 0, 0, &xr, 1, Unsorted);
+                g.set_clip(r);
+                wnd_paint_event e{r, g};
+                wnd->on_wnd_paint.emit(e);
+                x11::paint_gadgets(wnd, g, r);
+                XSetClipMask(x11::cached_display, cache->gc, None);
+                g.set_clip(full);
+            }
+
+            const rect shown = full.intersect(exposed);
+            if (shown.d.w > 0 && shown.d.h > 0)
+                present(win, cache, shown);
+            cache->valid = true;
+            return;
+        }
+
+        // A cached window with nothing damaged only needs its backbuffer
+        // shown again.
+        if (wnd->cached() && cache && cache->valid && damage.d.w == 0)
+        {
+            const rect shown = r.intersect(exposed);
+            if (shown.d.w > 0 && shown.d.h > 0)
+                present(win, cache, shown);
+            return;
+        }
+
+        // Always repaint the full backbuffer regardless of the damaged
+        // area — partial repaints cause artifacts when the clip region
+        // doesn't cover the whole window.
+        g.set_clip(r);
+
+        // Clear the full backbuffer to white, then let the user paint.
+        g.clear(rgba(255, 255, 255, 255));
+        wnd_paint_event e{r, g};
+        wnd->on_wnd_paint.emit(e);
+        x11::paint_gadgets(wnd, g, r);
+
+        // Present full backbuffer to window in one fast blit.
+        if (cache && cache->backbuffer)
+        {
+            present(win, cache, r);
+            cache->valid = true;
+        }
+    }
+
+    // Blocks until the display has input or timeout_ms elapses (-1 waits
+    // indefinitely). Returns true when events are queued.
+    static bool wait_for_events(Display *display, int timeout_ms)
+    {
+        if (XPending(display) > 0)
+            return true;
+
+        pollfd pfd{ConnectionNumber(display), POLLIN, 0};
+        poll(&pfd, 1, timeout_ms);
+        return XPending(display) > 0;
+    }
 
     int app::main_loop()
     {
@@ -19,13 +115,27 @@ namespace native
         bool running = true;
         native::wnd *wnd;
 
+        // Events arrive in runs for the same window; the hints turn the
+        // per-event lookups into a single slot compare.
+        std::size_t menubar_hint = 0;
+        std::size_t wnd_hint = 0;
+        std::size_t dispatch_hint = 0;
+
         while (running)
         {
+            // Paint once the queue is drained, just before the loop blocks.
+            if (XPending(x11::cached_display) == 0)
+            {
+                detail::frames().run(paint_window);
+                if (!wait_for_events(x11::cached_display, detail::frames().wait_ms()))
+                    continue;
+            }
+
             XNextEvent(x11::cached_display, &event);
 
             // Check if this event belongs to a menu bar or popup window.
             {
-                auto *xmenu = x11::menubar_bindings.from_a(event.xany.window);
+                auto *xmenu = x11::menubar_bindings.from_a(event.xany.window, menubar_hint);
                 if (xmenu)
                 {
                     x11::handle_menu_bar_event(xmenu, event);
@@ -33,81 +143,44 @@ namespace native
                 }
             }
 
-            wnd = x11::wnd_bindings.from_a(event.xany.window);
+            wnd = x11::wnd_bindings.from_a(event.xany.window, wnd_hint);
             if (!wnd)
                 continue;
 
-            if (auto *btn = dynamic_cast<native::button *>(wnd))
-            {
-                if (event.type == DestroyNotify || event.type == ClientMessage)
-                {
-                    // Let generic destruction flow handle lifecycle teardown.
-                }
-                else
-                {
-                    x11::handle_button_event(btn, event);
-                    continue;
-                }
-            }
+            // The window's own handler, chosen at create(), goes first.
+            if (auto *d = x11::dispatch_of(wnd, dispatch_hint); d && d->event && d->event(wnd, event))
+                continue;
 
             switch (event.type)
             {
             case Expose:
             {
-                // Drain any additional queued Expose events for this window
-                // so we only repaint once for the latest state.
-                {
-                    XEvent discard;
-                    while (XCheckTypedWindowEvent(x11::cached_display,
-                                                  event.xany.window, Expose, &discard))
-                    {}
-                }
-
-                // Always repaint the full backbuffer regardless of the Expose
-                // rectangle — partial repaints cause artifacts when the clip
-                // region doesn't cover the whole window.
-                auto &g = wnd->get_gpx();
+                // A retained or cached backbuffer already holds the
+                // exposed pixels.
                 auto *cache = x11::wnd_gpx_bindings.from_a(wnd);
-                rect r(0, 0,
-                       cache ? cache->buf_w : 0,
-                       cache ? cache->buf_h : 0);
-                g.set_clip(r);
-
-                // Clear the full backbuffer to white, then let the user paint.
-                g.clear(rgba(255, 255, 255, 255));
-                wnd_paint_event e{r, g};
-                wnd->on_wnd_paint.emit(e);
-
-                // Present full backbuffer to window in one fast blit.
-                if (cache && cache->backbuffer)
+                if ((wnd->preserve_contents() || wnd->cached()) && cache && cache->valid)
                 {
-                    XCopyArea(x11::cached_display,
-                              cache->backbuffer, event.xany.window, cache->gc,
-                              0, 0, cache->buf_w, cache->buf_h,
-                              0, 0);
-                    XFlush(x11::cached_display);
+                    detail::frames().present(wnd, rect(event.xexpose.x, event.xexpose.y,
+                                                       event.xexpose.width, event.xexpose.height));
+                    break;
                 }
+
+                // Repaint is deferred to the frame scheduler, which folds
+                // every Expose and invalidate() of this tick into one paint.
+                detail::frames().request(wnd);
+                break;
             }
-            break;
 
             case ConfigureNotify:
             {
+                // Children moved by the layout or by resize handlers
+                // reach the server together, with one flush.
                 size s(event.xconfigure.width, event.xconfigure.height);
+                app::begin_update();
                 wnd->on_native_resize(s);
                 wnd->on_wnd_resize.emit(s);
+                app::end_update();
                 wnd->on_wnd_move.emit(point(event.xconfigure.x, event.xconfigure.y));
-                // Resize menu bar if present
-                if (auto *aw = dynamic_cast<native::app_wnd *>(wnd))
-                {
-                    if (aw->menu.id())
-                    {
-                        auto *xm = x11::menu_bindings.from_a(aw->menu.id());
-                        if (xm && xm->bar_win && x11::cached_display)
-                            XResizeWindow(x11::cached_display, xm->bar_win,
-                                          static_cast<unsigned>(event.xconfigure.width),
-                                          x11::MENU_BAR_H);
-                    }
-                }
                 {
                     // Recreate the backbuffer whenever the window is resized.
                     auto *cache = x11::wnd_gpx_bindings.from_a(wnd);
@@ -120,7 +193,10 @@ namespace native
                         int nw = event.xconfigure.width;
                         int nh = event.xconfigure.height;
 
-                        XFreePixmap(display, cache->backbuffer);
+                        Pixmap old = cache->backbuffer;
+                        const int ow = cache->buf_w;
+                        const int oh = cache->buf_h;
+
                         cache->backbuffer = XCreatePixmap(display, event.xany.window,
                                                           nw, nh,
                                                           DefaultDepth(display, screen));
@@ -130,18 +206,67 @@ namespace native
                         XSetForeground(display, cache->gc, WhitePixel(display, screen));
                         XFillRectangle(display, cache->backbuffer, cache->gc,
                                        0, 0, nw, nh);
+
+                        // Preserved contents survive the resize; only the
+                        // newly uncovered strips are damaged.
+                        if (wnd->preserve_contents() && cache->valid)
+                        {
+                            XCopyArea(display, old, cache->backbuffer, cache->gc,
+                                      0, 0, ow, oh, 0, 0);
+                            if (nw > ow)
+                                detail::frames().request(wnd, rect(ow, 0, nw - ow, nh));
+                            if (nh > oh)
+                                detail::frames().request(wnd, rect(0, oh, nw, nh - oh));
+                        }
+                        else
+                        {
+                            cache->valid = false;
+                        }
+                        XFreePixmap(display, old);
                     }
                 }
                 break;
             }
 
             case MotionNotify:
-                wnd->on_mouse_move.emit(point(event.xmotion.x, event.xmotion.y));
+            {
+                // Fold the run of queued motion for this window into one
+                // on_mouse_move. Only consecutive events are taken, so
+                // motion never jumps ahead of a button or key event.
+                point last(event.xmotion.x, event.xmotion.y);
+                wnd->on_native_motion(last, static_cast<uint32_t>(event.xmotion.time));
+
+                XEvent next;
+                while (XEventsQueued(x11::cached_display, QueuedAfterReading) > 0)
+                {
+                    XPeekEvent(x11::cached_display, &next);
+                    if (next.type != MotionNotify || next.xany.window != event.xany.window)
+                        break;
+
+                    XNextEvent(x11::cached_display, &next);
+                    last = point(next.xmotion.x, next.xmotion.y);
+                    wnd->on_native_motion(last, static_cast<uint32_t>(next.xmotion.time));
+                }
+
+                x11::gadget_motion(wnd, last);
+                wnd->flush_native_motion();
+                break;
+            }
+
+            case LeaveNotify:
+                x11::gadget_leave(wnd);
                 break;
 
             case ButtonPress:
             case ButtonRelease:
             {
+                // Windowless controls under the pointer take the left
+                // button before the window sees it.
+                if (event.xbutton.button == Button1 &&
+                    x11::gadget_button(wnd, point(event.xbutton.x, event.xbutton.y),
+                                       event.type == ButtonPress))
+                    break;
+
                 mouse_button btn = mouse_button::none;
                 mouse_action act = (event.type == ButtonPress)
                                        ? mouse_action::press
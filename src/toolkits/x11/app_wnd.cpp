@@ -7,6 +7,30 @@
 #include "bindings.h"
 #include "globals.h"
 
+namespace x11
+{
+    // Keeps the menu bar as wide as its window; the event then goes on
+    // to the generic handling.
+    static bool app_wnd_event(native::wnd *w, const XEvent &e)
+    {
+        if (e.type != ConfigureNotify)
+            return false;
+
+        auto *aw = static_cast<native::app_wnd *>(w);
+        if (aw->menu.id())
+        {
+            auto *xm = menu_bindings.from_a(aw->menu.id());
+            if (xm && xm->bar_win && cached_display)
+                XResizeWindow(cached_display, xm->bar_win,
+                              static_cast<unsigned>(e.xconfigure.width),
+                              MENU_BAR_H);
+        }
+        return false;
+    }
+
+    static const dispatch app_wnd_dispatch{app_wnd_event, nullptr};
+}
+
 namespace native
 {
     app_wnd::app_wnd(std::string title, coord x, coord y, dim w, dim h)
@@ -73,7 +97,8 @@ namespace native
         // Subscribe to events
         XSelectInput(x11::cached_display, main_wnd,
                      ExposureMask | StructureNotifyMask | ButtonPressMask |
-                         ButtonReleaseMask | PointerMotionMask | KeyPressMask | KeyReleaseMask);
+                         ButtonReleaseMask | PointerMotionMask | LeaveWindowMask |
+                         KeyPressMask | KeyReleaseMask);
 
         // Handle WM_DELETE_WINDOW
         x11::wm_delete_window_atom = XInternAtom(x11::cached_display, "WM_DELETE_WINDOW", False);
@@ -81,6 +106,7 @@ namespace native
 
         // Register in window binding registry
         x11::wnd_bindings.register_pair(main_wnd, const_cast<app_wnd *>(this));
+        x11::wnd_dispatch.insert(const_cast<app_wnd *>(this), &x11::app_wnd_dispatch);
 
         // Mark as created
         _created = true;
@@ -109,12 +135,16 @@ namespace native
                     XFreeGC(x11::cached_display, cache->gc);
                 if (cache->backbuffer)
                     XFreePixmap(x11::cached_display, cache->backbuffer);
+                for (const auto &g : cache->gradients)
+                    XFreePixmap(x11::cached_display, g.pixmap);
                 delete cache;
                 x11::wnd_gpx_bindings.unregister_by_a(self);
             }
 
             XDestroyWindow(x11::cached_display, win);
             x11::wnd_bindings.unregister_by_b(self);
+            x11::wnd_dispatch.erase(self);
+            x11::destroy_gadgets(self);
         }
 
         _created = false;
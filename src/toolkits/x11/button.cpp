@@ -76,11 +76,22 @@ namespace x11
         XFlush(cached_display);
     }
 
-    void handle_button_event(native::button *b, const XEvent &e)
+    static void paint_button(native::wnd *w)
     {
+        draw_button(button_bindings.from_a(static_cast<native::button *>(w)));
+    }
+
+    // Buttons own every event of their window except the ones that end
+    // its lifetime, which go through the generic destruction flow.
+    static bool button_event(native::wnd *w, const XEvent &e)
+    {
+        if (e.type == DestroyNotify || e.type == ClientMessage)
+            return false;
+
+        auto *b = static_cast<native::button *>(w);
         auto *h = button_bindings.from_a(b);
         if (!h)
-            return;
+            return true;
 
         switch (e.type)
         {
@@ -134,7 +145,27 @@ namespace x11
         default:
             break;
         }
+        return true;
     }
+
+    static const dispatch button_dispatch{button_event, paint_button};
+
+    // Windowless buttons draw into the parent's backbuffer.
+    static void draw_gadget_button(native::wnd *w, native::gpx &g, const gadget &state)
+    {
+        native::control_paint painter(g);
+        native::control_paint::state st;
+        st.hot = state.hover;
+        st.pressed = state.pressed;
+        painter.draw_button(w->bounds(), static_cast<native::button *>(w)->text(), st);
+    }
+
+    static void click_button(native::wnd *w)
+    {
+        static_cast<native::button *>(w)->on_click.emit();
+    }
+
+    static const dispatch gadget_button_dispatch{nullptr, nullptr, draw_gadget_button, click_button};
 } // namespace x11
 
 namespace native
@@ -162,6 +193,7 @@ namespace native
     button &button::set_text(const std::string &text)
     {
         _text = text;
+        invalidate_measure();
 
         if (_created)
             invalidate();
@@ -181,6 +213,15 @@ namespace native
         if (!p)
             throw std::runtime_error("X11: button requires a parent window.");
 
+        auto *self = const_cast<button *>(this);
+        if (_windowless)
+        {
+            x11::add_gadget(self, &x11::gadget_button_dispatch);
+            _created = true;
+            self->on_wnd_create.emit();
+            return;
+        }
+
         Window parent_win = x11::wnd_bindings.from_b(p);
         if (!parent_win)
             throw std::runtime_error("X11: button parent is not created.");
@@ -205,7 +246,6 @@ namespace native
                      EnterWindowMask | LeaveWindowMask |
                      ButtonPressMask | ButtonReleaseMask);
 
-        auto *self = const_cast<button *>(this);
         x11::wnd_bindings.register_pair(btn, self);
 
         auto *h = new x11::x11button();
@@ -217,6 +257,7 @@ namespace native
         XSetWindowBorder(x11::cached_display, btn, BlackPixel(x11::cached_display, screen));
 
         x11::button_bindings.register_pair(self, h);
+        x11::wnd_dispatch.insert(self, &x11::button_dispatch);
 
         _created = true;
         self->on_wnd_create.emit();
@@ -227,6 +268,12 @@ namespace native
         if (!_created)
             throw std::runtime_error("X11: Cannot show button before it is created.");
 
+        if (_windowless)
+        {
+            x11::show_gadget(const_cast<button *>(this));
+            return;
+        }
+
         auto *h = x11::button_bindings.from_a(const_cast<button *>(this));
         if (!h || !h->win)
             throw std::runtime_error("X11: Missing button window binding.");
@@ -241,6 +288,13 @@ namespace native
             return;
 
         auto *self = const_cast<button *>(this);
+        if (_windowless)
+        {
+            x11::remove_gadget(self);
+            _created = false;
+            return;
+        }
+
         auto *h = x11::button_bindings.from_a(self);
 
         if (h)
@@ -256,6 +310,7 @@ namespace native
             x11::button_bindings.unregister_by_a(self);
             delete h;
         }
+        x11::wnd_dispatch.erase(self);
 
         _created = false;
     }
@@ -5,26 +5,20 @@
 #include "globals.h"
 
 // font_t on X11: the platform handle (x11font) owns an X11 core Font and
-// lives in x11::font_bindings, keyed by the font's opaque uint32_t id.
+// lives in x11::font_handles. The font's opaque uint32_t id is its
+// generation-checked handle there.
 
 namespace
 {
-    uint32_t next_id()
-    {
-        static uint32_t counter = 0;
-        return ++counter;
-    }
-
     void release(uint32_t id)
     {
-        auto *f = x11::font_bindings.from_a(id);
+        auto *f = x11::font_handles.release(id);
         if (f)
         {
             if (f->owned && f->display && f->xfont)
                 XUnloadFont(f->display, f->xfont);
             delete f;
         }
-        x11::font_bindings.unregister_by_a(id);
     }
 
     uint32_t register_font(Display *display, Font xfont, bool owned)
@@ -33,9 +27,7 @@ namespace
         h->display = display;
         h->xfont   = xfont;
         h->owned   = owned;
-        uint32_t id = next_id();
-        x11::font_bindings.register_pair(id, h);
-        return id;
+        return x11::font_handles.insert(h);
     }
 
     Font try_load(Display *display, std::initializer_list<const char *> names)
@@ -98,13 +90,10 @@ font_t font_t::create(const font_spec &spec)
 const font_t &font_t::stock(font_role role)
 {
     static font_t s[5];
-    static bool initialized = false;
-    if (!initialized)
-    {
-        initialized = true;
-
+    static std::once_flag once;
+    std::call_once(once, []() {
         Display *display = x11::cached_display;
-        if (!display) return s[(int)role];
+        if (!display) return;
 
         const char *x_font = XGetDefault(display, "*", "font");
         Font system_f = x_font ? XLoadFont(display, x_font) : 0;
@@ -133,7 +122,7 @@ const font_t &font_t::stock(font_role role)
         s[(int)font_role::title]._spec.name   = s[(int)font_role::system]._spec.name;
         s[(int)font_role::small_]._spec.name  = s[(int)font_role::system]._spec.name;
         s[(int)font_role::control]._spec.name = s[(int)font_role::system]._spec.name;
-    }
+    });
     return s[(int)role];
 }
 
@@ -0,0 +1,232 @@
+#include <vector>
+
+#include <native.h>
+
+#include "globals.h"
+
+namespace
+{
+    x11::gadget *state_of(x11::x11controls *c, native::wnd *w)
+    {
+        const std::size_t i = c->state.find(w);
+        return i != c->state.npos ? &c->state.value(i) : nullptr;
+    }
+
+    x11::x11controls *controls_of(native::wnd *w)
+    {
+        native::wnd *p = w->parent();
+        return p ? x11::controls_bindings.from_a(p) : nullptr;
+    }
+
+    // Moves hover to the topmost visible control under p; only the
+    // previously and newly hovered controls are touched and damaged.
+    void update_hover(native::wnd *owner, x11::x11controls *c, native::point p)
+    {
+        native::wnd *now = c->grid.at(p, [&](native::wnd *w) {
+            auto *g = state_of(c, w);
+            return g && g->visible;
+        });
+        if (now == c->hovered)
+            return;
+
+        if (native::wnd *w = c->hovered)
+        {
+            if (auto *g = state_of(c, w))
+                g->hover = false;
+            owner->invalidate(w->bounds());
+        }
+        if (now)
+        {
+            state_of(c, now)->hover = true;
+            owner->invalidate(now->bounds());
+        }
+        c->hovered = now;
+    }
+
+    void forget(x11::x11controls *c, native::wnd *w)
+    {
+        c->grid.erase(w);
+        c->state.erase(w);
+        if (c->hovered == w)
+            c->hovered = nullptr;
+        if (c->pressed == w)
+            c->pressed = nullptr;
+    }
+}
+
+namespace x11
+{
+    void add_gadget(native::wnd *w, const dispatch *kind)
+    {
+        native::wnd *p = w->parent();
+        if (!p)
+            return;
+
+        auto *c = controls_bindings.from_a(p);
+        if (!c)
+        {
+            c = new x11controls();
+            controls_bindings.register_pair(p, c);
+        }
+
+        gadget g;
+        g.kind = kind;
+        c->state.insert(w, g);
+        c->grid.place(w, w->bounds());
+    }
+
+    void show_gadget(native::wnd *w)
+    {
+        auto *c = controls_of(w);
+        auto *g = c ? state_of(c, w) : nullptr;
+        if (!g)
+            return;
+
+        g->visible = true;
+        w->parent()->invalidate(w->bounds());
+    }
+
+    void remove_gadget(native::wnd *w)
+    {
+        auto *c = controls_of(w);
+        if (!c || !c->grid.contains(w))
+            return;
+
+        forget(c, w);
+        w->parent()->invalidate(w->bounds());
+    }
+
+    void gadget_moved(native::wnd *w, const native::rect &old_bounds)
+    {
+        // During set_parent() the new parent's layout may move w before
+        // it has been handed over; gadget_reparented() places it then.
+        auto *c = controls_of(w);
+        if (!c || !c->grid.contains(w))
+            return;
+
+        c->grid.place(w, w->bounds());
+        w->parent()->invalidate(old_bounds);
+        w->parent()->invalidate(w->bounds());
+    }
+
+    void gadget_reparented(native::wnd *w, native::wnd *old_parent)
+    {
+        auto *old = old_parent ? controls_bindings.from_a(old_parent) : nullptr;
+        auto *g = old ? state_of(old, w) : nullptr;
+        if (!g)
+            return;
+
+        gadget moved = *g;
+        moved.hover = false;
+        moved.pressed = false;
+        forget(old, w);
+        old_parent->invalidate(w->bounds());
+
+        if (native::wnd *p = w->parent())
+        {
+            add_gadget(w, moved.kind);
+            if (auto *c = controls_bindings.from_a(p))
+                *state_of(c, w) = moved;
+            p->invalidate(w->bounds());
+        }
+    }
+
+    void paint_gadgets(native::wnd *owner, native::gpx &g, const native::rect &area)
+    {
+        auto *c = controls_bindings.from_a(owner);
+        if (!c)
+            return;
+
+        const native::rect clip = g.clip();
+        c->grid.in(area, c->painting);
+        for (native::wnd *w : c->painting)
+        {
+            auto *st = state_of(c, w);
+            if (!st || !st->visible || !st->kind || !st->kind->draw)
+                continue;
+
+            g.set_clip(area.intersect(w->bounds()));
+            st->kind->draw(w, g, *st);
+        }
+        g.set_clip(clip);
+    }
+
+    void gadget_motion(native::wnd *owner, native::point p)
+    {
+        if (auto *c = controls_bindings.from_a(owner))
+            update_hover(owner, c, p);
+    }
+
+    bool gadget_button(native::wnd *owner, native::point p, bool pressed)
+    {
+        auto *c = controls_bindings.from_a(owner);
+        if (!c)
+            return false;
+
+        update_hover(owner, c, p);
+
+        if (pressed)
+        {
+            if (native::wnd *w = c->pressed)
+            {
+                if (auto *g = state_of(c, w))
+                    g->pressed = false;
+                owner->invalidate(w->bounds());
+            }
+
+            c->pressed = c->hovered;
+            if (native::wnd *w = c->pressed)
+            {
+                state_of(c, w)->pressed = true;
+                owner->invalidate(w->bounds());
+            }
+            return c->pressed != nullptr;
+        }
+
+        native::wnd *w = c->pressed;
+        if (!w)
+            return false;
+
+        // click may destroy the control, or the window, so it is looked
+        // up again before the call.
+        c->pressed = nullptr;
+        auto *g = state_of(c, w);
+        if (!g)
+            return true;
+        g->pressed = false;
+        owner->invalidate(w->bounds());
+
+        const dispatch *kind = g->kind;
+        if (w->bounds().contains(p) && kind && kind->click)
+        {
+            auto *now = controls_bindings.from_a(owner);
+            if (now && now->grid.contains(w))
+                kind->click(w);
+        }
+        return true;
+    }
+
+    void gadget_leave(native::wnd *owner)
+    {
+        auto *c = controls_bindings.from_a(owner);
+        if (!c)
+            return;
+
+        if (native::wnd *w = c->hovered)
+        {
+            if (auto *g = state_of(c, w))
+                g->hover = false;
+            owner->invalidate(w->bounds());
+        }
+        c->hovered = nullptr;
+    }
+
+    void destroy_gadgets(native::wnd *owner)
+    {
+        if (auto *c = controls_bindings.from_a(owner))
+        {
+            controls_bindings.unregister_by_a(owner);
+            delete c;
+        }
+    }
+}
@@ -11,8 +11,10 @@ namespace x11
     Display *cached_display = nullptr;
     Atom wm_delete_window_atom = None;
     native::bindings<native::wnd *, x11gpx *> wnd_gpx_bindings;
-    native::bindings<uint32_t, x11font *> font_bindings;
+    native::handle_table<x11font> font_handles;
     native::bindings<Window,   x11menu *> menubar_bindings;
     native::bindings<uint32_t, x11menu *> menu_bindings;
     native::bindings<native::button *, x11button *> button_bindings;
+    native::detail::flat_map<native::wnd *, const dispatch *> wnd_dispatch;
+    native::bindings<native::wnd *, x11controls *> controls_bindings;
 }
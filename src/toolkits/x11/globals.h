@@ -8,6 +8,8 @@
 
 #include <native.h>
 #include <bindings.h>
+#include <handle_table.h>
+#include <spatial_grid.h>
 
 namespace x11
 {
@@ -24,6 +26,15 @@ namespace x11
     };
 
     // Internally cached values for gc and backbuffer
+    // A gradient rendered at one size and kept on the server.
+    struct x11gradient
+    {
+        uint64_t serial;
+        int w;
+        int h;
+        Pixmap pixmap;
+    };
+
     typedef struct
     {
         GC gc = nullptr;
@@ -33,13 +44,21 @@ namespace x11
         int buf_w = 0;
         int buf_h = 0;
 
+        // Backbuffer holds painted content; with preserve_contents() an
+        // Expose is then served by a blit instead of a repaint.
+        bool valid = false;
+
         // Cached draw parameters
         native::rgba current_fg = 0xFFFFFFFF;
         int current_thickness = -1;
+        int current_cap = -1;
+
+        // Gradients uploaded by fill_rect_gradient, most recent first
+        std::vector<x11gradient> gradients;
     } x11gpx;
 
     extern native::bindings<native::wnd *, x11gpx *> wnd_gpx_bindings;
-    extern native::bindings<uint32_t, x11font *> font_bindings;
+    extern native::handle_table<x11font> font_handles;
 
     static constexpr int MENU_BAR_H = 20;
 
@@ -80,5 +99,69 @@ namespace x11
     };
 
     extern native::bindings<native::button *, x11button *> button_bindings;
-    void handle_button_event(native::button *b, const XEvent &e);
+
+    // State of a windowless control, kept by its parent.
+    struct gadget;
+
+    // Per-window dispatch target, chosen once by create(). The main loop
+    // hands every event to `event` before the generic handling; it
+    // returns true when it consumed the event. `paint`, when set,
+    // replaces the generic backbuffer paint. Windows without a target
+    // get the generic handling only.
+    //
+    // Windowless controls use `draw`, which paints the control into its
+    // parent's gpx in parent coordinates, and `click`, which runs when a
+    // press and release both land on the control.
+    struct dispatch
+    {
+        bool (*event)(native::wnd *w, const XEvent &e) = nullptr;
+        void (*paint)(native::wnd *w) = nullptr;
+        void (*draw)(native::wnd *w, native::gpx &g, const gadget &state) = nullptr;
+        void (*click)(native::wnd *w) = nullptr;
+    };
+
+    struct gadget
+    {
+        const dispatch *kind = nullptr;
+        bool visible = false;
+        bool hover = false;
+        bool pressed = false;
+    };
+
+    // Windowless controls of one window. The grid indexes them by bounds
+    // for hit-testing and damage; the hovered and pressed ones are kept
+    // apart so pointer events touch only those.
+    struct x11controls
+    {
+        native::detail::spatial_grid<native::wnd> grid;
+        native::detail::flat_map<native::wnd *, gadget> state;
+        native::wnd *hovered = nullptr;
+        native::wnd *pressed = nullptr;
+        std::vector<native::wnd *> painting; // Reused by paint_gadgets().
+    };
+
+    extern native::bindings<native::wnd *, x11controls *> controls_bindings;
+
+    void add_gadget(native::wnd *w, const dispatch *kind);
+    void show_gadget(native::wnd *w);
+    void remove_gadget(native::wnd *w);
+    // Keep a control's index entry in step with its bounds and parent.
+    void gadget_moved(native::wnd *w, const native::rect &old_bounds);
+    void gadget_reparented(native::wnd *w, native::wnd *old_parent);
+    // Paints the controls of owner that overlap area.
+    void paint_gadgets(native::wnd *owner, native::gpx &g, const native::rect &area);
+    // Pointer routing from owner's events. gadget_button returns true
+    // when a control consumed the left button event.
+    void gadget_motion(native::wnd *owner, native::point p);
+    bool gadget_button(native::wnd *owner, native::point p, bool pressed);
+    void gadget_leave(native::wnd *owner);
+    void destroy_gadgets(native::wnd *owner);
+
+    extern native::detail::flat_map<native::wnd *, const dispatch *> wnd_dispatch;
+
+    inline const dispatch *dispatch_of(native::wnd *w, std::size_t &hint)
+    {
+        const std::size_t i = wnd_dispatch.find(w, hint);
+        return i != wnd_dispatch.npos ? wnd_dispatch.value(i) : nullptr;
+    }
 }
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
@@ -6,6 +9,7 @@
 #include <native.h>
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 // Apply ink and pen to the cached GC only when they have changed.
 // No GC-level clip is set — the full backbuffer is always repainted,
@@ -20,13 +24,56 @@ static void apply_gc(Display *display, x11::x11gpx *cache, native::gpx_wnd *self
         cache->current_fg = self->ink();
     }
 
-    if (cache->current_thickness != self->pen())
+    if (cache->current_thickness != self->pen() || cache->current_cap != static_cast<int>(self->cap()))
     {
-        XSetLineAttributes(display, cache->gc, self->pen(), LineSolid, CapButt, JoinMiter);
+        const int cap = self->cap() == native::line_cap::round    ? CapRound
+                        : self->cap() == native::line_cap::square ? CapProjecting
+                                                                  : CapButt;
+        XSetLineAttributes(display, cache->gc, self->pen(), LineSolid, cap, JoinMiter);
         cache->current_thickness = self->pen();
+        cache->current_cap = static_cast<int>(self->cap());
     }
 }
 
+// Uploads src into a new pixmap of the window's depth.
+static Pixmap upload(Display *display, x11::x11gpx *cache, const native::img &src)
+{
+    const int screen = DefaultScreen(display);
+    Pixmap pixmap = XCreatePixmap(display, cache->backbuffer, src.w(), src.h(), DefaultDepth(display, screen));
+    XImage *ximg = XCreateImage(display, DefaultVisual(display, screen), DefaultDepth(display, screen),
+                                ZPixmap, 0,
+                                reinterpret_cast<char *>(const_cast<native::rgba *>(src.pixels())),
+                                src.w(), src.h(), 32, 0);
+    XPutImage(display, pixmap, cache->gc, ximg, 0, 0, 0, 0, src.w(), src.h());
+    ximg->data = nullptr; // Still owned by src
+    XDestroyImage(ximg);
+    return pixmap;
+}
+
+// One polygon for every contour of p. Each contour after the first is
+// reached from the first vertex and left back to it along the same
+// seam, so the seams cancel under either fill rule.
+static std::vector<XPoint> path_polygon(const native::path &p)
+{
+    std::vector<XPoint> points;
+    const auto &v = p.vertices();
+    const auto at = [&](std::size_t i) {
+        return XPoint{static_cast<short>(std::lround(v[i].x)), static_cast<short>(std::lround(v[i].y))};
+    };
+
+    for (const auto &c : p.contours())
+    {
+        if (c.count < 2)
+            continue;
+        for (std::size_t i = 0; i < c.count; ++i)
+            points.push_back(at(c.first + i));
+        points.push_back(at(c.first));
+        if (points.size() > c.count + 1)
+            points.push_back(points.front());
+    }
+    return points;
+}
+
 namespace native
 {
 
@@ -36,7 +83,7 @@ namespace native
         if (!x11::cached_display)
             throw std::runtime_error("X11: No display available for gpx_wnd");
 
-        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache)
         {
             Display *display = x11::cached_display;
@@ -80,7 +127,7 @@ namespace native
     gpx &gpx_wnd::clear(rgba color)
     {
         Display *display = x11::cached_display;
-        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->backbuffer) return *this;
 
         XSetForeground(display, cache->gc, color);
@@ -93,7 +140,7 @@ namespace native
     gpx &gpx_wnd::draw_line(point from, point to)
     {
         Display *display = x11::cached_display;
-        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->backbuffer) return *this;
 
         apply_gc(display, cache, this);
@@ -105,7 +152,7 @@ namespace native
     gpx &gpx_wnd::draw_rect(rect r, bool filled)
     {
         Display *display = x11::cached_display;
-        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->backbuffer) return *this;
 
         apply_gc(display, cache, this);
@@ -122,12 +169,12 @@ namespace native
     gpx &gpx_wnd::draw_text(const std::string &text, point p)
     {
         Display *display = x11::cached_display;
-        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->backbuffer) return *this;
 
         apply_gc(display, cache, this);
 
-        auto *fh = x11::font_bindings.from_a(font().id());
+        auto *fh = x11::font_handles.get(font().id());
         if (fh && fh->xfont)
             XSetFont(display, cache->gc, fh->xfont);
 
@@ -139,7 +186,7 @@ namespace native
     gpx &gpx_wnd::draw_img(const img &src, point dst)
     {
         Display *display = x11::cached_display;
-        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd);
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
         if (!cache || !cache->backbuffer) return *this;
 
         apply_gc(display, cache, this);
@@ -153,8 +200,115 @@ namespace native
 
         XPutImage(display, cache->backbuffer, cache->gc,
                   ximg, 0, 0, dst.x, dst.y, src.w(), src.h());
+        ximg->data = nullptr; // Still owned by src
         XDestroyImage(ximg);
         return *this;
     }
 
+    gpx &gpx_wnd::copy_area(const rect &src, point dst)
+    {
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
+        if (!cache || !cache->backbuffer) return *this;
+
+        rect s = src;
+        point d = dst;
+        if (!detail::clip_copy(_clip, rect(0, 0, cache->buf_w, cache->buf_h), s, d))
+            return *this;
+
+        // XCopyArea handles overlapping source and destination itself.
+        XCopyArea(x11::cached_display, cache->backbuffer, cache->backbuffer, cache->gc,
+                  s.p.x, s.p.y, s.d.w, s.d.h, d.x, d.y);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_path(const path &p, fill_rule rule)
+    {
+        Display *display = x11::cached_display;
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
+        if (!cache || !cache->backbuffer) return *this;
+
+        std::vector<XPoint> points = path_polygon(p);
+        if (points.size() < 3) return *this;
+
+        apply_gc(display, cache, this);
+        XSetFillRule(display, cache->gc, rule == fill_rule::even_odd ? EvenOddRule : WindingRule);
+        XFillPolygon(display, cache->backbuffer, cache->gc,
+                     points.data(), static_cast<int>(points.size()), Complex, CoordModeOrigin);
+        return *this;
+    }
+
+    gpx &gpx_wnd::draw_path(const path &p)
+    {
+        Display *display = x11::cached_display;
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
+        if (!cache || !cache->backbuffer) return *this;
+
+        apply_gc(display, cache, this);
+
+        std::vector<XPoint> points;
+        const auto &v = p.vertices();
+        for (const auto &c : p.contours())
+        {
+            points.clear();
+            for (std::size_t i = 0; i < c.count; ++i)
+                points.push_back(XPoint{static_cast<short>(std::lround(v[c.first + i].x)),
+                                        static_cast<short>(std::lround(v[c.first + i].y))});
+            if (c.closed && c.count > 2)
+                points.push_back(points.front());
+            if (points.size() > 1)
+                XDrawLines(display, cache->backbuffer, cache->gc,
+                           points.data(), static_cast<int>(points.size()), CoordModeOrigin);
+        }
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_rect_gradient(const rect &r, const gradient &g)
+    {
+        Display *display = x11::cached_display;
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
+        if (!cache || !cache->backbuffer || r.d.w == 0 || r.d.h == 0) return *this;
+
+        // The same gradients come back at the same sizes paint after
+        // paint, so the last few stay on the server and are copied from
+        // there.
+        static constexpr std::size_t kept = 8;
+        auto &list = cache->gradients;
+        auto it = std::find_if(list.begin(), list.end(), [&](const x11::x11gradient &e) {
+            return e.serial == g.serial() && e.w == r.d.w && e.h == r.d.h;
+        });
+        if (it == list.end())
+        {
+            if (list.size() == kept)
+            {
+                XFreePixmap(display, list.back().pixmap);
+                list.pop_back();
+            }
+            list.insert(list.begin(), x11::x11gradient{g.serial(), r.d.w, r.d.h,
+                                                       upload(display, cache, g.image(r.d.w, r.d.h))});
+        }
+        else
+            std::rotate(list.begin(), it, it + 1);
+
+        XCopyArea(display, list.front().pixmap, cache->backbuffer, cache->gc,
+                  0, 0, r.d.w, r.d.h, r.p.x, r.p.y);
+        return *this;
+    }
+
+    gpx &gpx_wnd::fill_rect_pattern(const rect &r, const img &tile, point origin)
+    {
+        Display *display = x11::cached_display;
+        auto *cache = x11::wnd_gpx_bindings.from_a(_wnd, _state_hint);
+        if (!cache || !cache->backbuffer || r.d.w == 0 || r.d.h == 0) return *this;
+
+        // The GC keeps its own reference to the tile.
+        Pixmap pixmap = upload(display, cache, tile);
+        XSetTile(display, cache->gc, pixmap);
+        XSetTSOrigin(display, cache->gc, origin.x, origin.y);
+        XSetFillStyle(display, cache->gc, FillTiled);
+        XFillRectangle(display, cache->backbuffer, cache->gc, r.p.x, r.p.y, r.d.w, r.d.h);
+        XSetFillStyle(display, cache->gc, FillSolid);
+        XFreePixmap(display, pixmap);
+        return *this;
+    }
+
 } // namespace native
@@ -5,15 +5,25 @@
 
 #include <native.h>
 #include "bindings.h"
+#include "frame_scheduler.h"
+#include "layout_queue.h"
 #include "gpx_wnd.h"
 #include "globals.h"
+#include "scroll.h"
 
 namespace
 {
-    native::rect layout_bounds_for(native::wnd *w)
+    // Deferred geometry for open layout transactions.
+    void apply_geometry(native::wnd *w)
     {
-        native::size d = w->dimensions();
-        return native::rect(0, 0, d.w, d.h);
+        const native::rect r = w->bounds();
+        if (Window win = x11::wnd_bindings.from_b(w))
+            XMoveResizeWindow(x11::cached_display, win, r.p.x, r.p.y, r.d.w, r.d.h);
+    }
+
+    void flush_display()
+    {
+        XFlush(x11::cached_display);
     }
 }
 
@@ -49,10 +59,19 @@ namespace native
                 _parent->_layout->remove_child(this);
         }
 
-        if (_created)
+        if (_created && _windowless)
+        {
+            x11::remove_gadget(this);
+        }
+        else if (_created)
         {
             x11::wnd_bindings.unregister_by_b(this);
+            x11::wnd_dispatch.erase(this);
         }
+        x11::destroy_gadgets(this);
+
+        detail::frames().cancel(this);
+        detail::layouts().cancel(this);
     }
 
     point wnd::position() const
@@ -62,9 +81,18 @@ namespace native
 
     wnd &wnd::set_position(const point &p)
     {
+        const rect old = _bounds;
         _bounds.p = p;
 
-        if (_created)
+        if (_created && _windowless)
+        {
+            x11::gadget_moved(this, old);
+        }
+        else if (_created && detail::layouts().deferring())
+        {
+            detail::layouts().move(this, old, apply_geometry, flush_display);
+        }
+        else if (_created)
         {
             Window win = x11::wnd_bindings.from_b(this);
             XMoveWindow(x11::cached_display, win, p.x, p.y);
@@ -81,17 +109,25 @@ namespace native
 
     wnd &wnd::set_dimensions(const size &s)
     {
+        const rect old = _bounds;
         _bounds.d = s;
 
-        if (_created)
+        if (_created && _windowless)
+        {
+            x11::gadget_moved(this, old);
+        }
+        else if (_created && detail::layouts().deferring())
+        {
+            detail::layouts().move(this, old, apply_geometry, flush_display);
+        }
+        else if (_created)
         {
             Window win = x11::wnd_bindings.from_b(this);
             XResizeWindow(x11::cached_display, win, s.w, s.h);
             XFlush(x11::cached_display);
         }
 
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
 
         return *this;
     }
@@ -103,17 +139,25 @@ namespace native
 
     wnd &wnd::set_bounds(const rect &r)
     {
+        const rect old = _bounds;
         _bounds = r;
 
-        if (_created)
+        if (_created && _windowless)
+        {
+            x11::gadget_moved(this, old);
+        }
+        else if (_created && detail::layouts().deferring())
+        {
+            detail::layouts().move(this, old, apply_geometry, flush_display);
+        }
+        else if (_created)
         {
             Window win = x11::wnd_bindings.from_b(this);
             XMoveResizeWindow(x11::cached_display, win, r.p.x, r.p.y, r.d.w, r.d.h);
             XFlush(x11::cached_display);
         }
 
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
 
         return *this;
     }
@@ -121,8 +165,7 @@ namespace native
     void wnd::on_native_resize(const size &s)
     {
         _bounds.d = s;
-        if (_layout)
-            _layout->relayout(this, layout_bounds_for(this));
+        relayout();
     }
 
     void wnd::set_layout(std::unique_ptr<layout_manager> layout)
@@ -132,7 +175,7 @@ namespace native
         {
             for (auto *child : _children)
                 _layout->add_child(child);
-            _layout->relayout(this, layout_bounds_for(this));
+            relayout();
         }
     }
 
@@ -156,7 +199,7 @@ namespace native
             if (old_parent->_layout)
             {
                 old_parent->_layout->remove_child(this);
-                old_parent->_layout->relayout(old_parent, layout_bounds_for(old_parent));
+                old_parent->relayout();
             }
         }
 
@@ -170,11 +213,15 @@ namespace native
             if (_parent->_layout)
             {
                 _parent->_layout->add_child(this);
-                _parent->_layout->relayout(_parent, layout_bounds_for(_parent));
+                _parent->relayout();
             }
         }
 
-        if (_created && p && p->_created)
+        if (_created && _windowless)
+        {
+            x11::gadget_reparented(this, old_parent);
+        }
+        else if (_created && p && p->_created)
         {
             Window child = x11::wnd_bindings.from_b(this);
             Window parent = x11::wnd_bindings.from_b(p);
@@ -195,20 +242,31 @@ namespace native
         if (!_created)
             return const_cast<wnd &>(*this);
 
-        Window win = x11::wnd_bindings.from_b(const_cast<wnd *>(this));
-        XClearArea(x11::cached_display, win, 0, 0, 0, 0, True);
-        XFlush(x11::cached_display);
+        // A windowless control lives in its parent's backbuffer.
+        if (_windowless)
+        {
+            if (_parent)
+                _parent->invalidate(_bounds);
+            return const_cast<wnd &>(*this);
+        }
+
+        detail::frames().request(this);
         return const_cast<wnd &>(*this);
     }
 
     wnd &wnd::invalidate(const rect &r) const
     {
-        if (!_created)
-            return const_cast<wnd &>(*this);
-
-        Window win = x11::wnd_bindings.from_b(const_cast<wnd *>(this));
-        XClearArea(x11::cached_display, win, r.p.x, r.p.y, r.d.w, r.d.h, True);
-        XFlush(x11::cached_display);
+        // Without preserve_contents() the backbuffer is repainted whole.
+        if (_created && _windowless)
+        {
+            if (_parent)
+                _parent->invalidate(rect(static_cast<coord>(_bounds.p.x + r.p.x),
+                                         static_cast<coord>(_bounds.p.y + r.p.y),
+                                         r.d.w, r.d.h)
+                                        .intersect(_bounds));
+        }
+        else if (_created)
+            detail::frames().request(this, r);
         return const_cast<wnd &>(*this);
     }
 
@@ -223,4 +281,27 @@ namespace native
         return *_gpx;
     }
 
+
+    namespace detail
+    {
+        bool retain_backend_native(const wnd *)
+        {
+            // The backbuffer is kept between paints, so preserve_contents()
+            // is honoured.
+            return true;
+        }
+
+        bool scroll_backend_native(wnd *w, const rect &r, const scroll_plan &plan)
+        {
+            // Without retained contents the backbuffer is repainted whole
+            // anyway, so there is nothing worth moving.
+            auto *cache = x11::wnd_gpx_bindings.from_a(w);
+            if (!w->preserve_contents() || !cache || !cache->valid)
+                return false;
+
+            scroll_retained(w, r, plan);
+            return true;
+        }
+    }
+
 } // namespace native
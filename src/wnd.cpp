@@ -0,0 +1,166 @@
+#include <native.h>
+
+#include "control_paint_backend.h"
+#include "layout_queue.h"
+#include "scroll.h"
+
+namespace native
+{
+
+    wnd &wnd::set_preserve_contents(bool enabled)
+    {
+        if (_preserve_contents == enabled)
+            return *this;
+
+        // Whatever the backbuffer holds was drawn under the old mode.
+        _preserve_contents = enabled;
+        if (_created)
+            invalidate();
+        return *this;
+    }
+
+    bool wnd::preserve_contents() const
+    {
+        return _preserve_contents;
+    }
+
+    bool wnd::contents_retained() const
+    {
+        return _preserve_contents && detail::retain_backend_native(this);
+    }
+
+    wnd &wnd::set_cached(bool enabled)
+    {
+        if (_cached == enabled)
+            return *this;
+
+        // Fill the cache from a full paint.
+        _cached = enabled;
+        if (_created)
+            invalidate();
+        return *this;
+    }
+
+    bool wnd::cached() const
+    {
+        return _cached;
+    }
+
+    wnd &wnd::set_windowless(bool enabled)
+    {
+        // A created control keeps the kind of surface it was created with.
+        if (!_created)
+            _windowless = enabled;
+        return *this;
+    }
+
+    bool wnd::windowless() const
+    {
+        return _windowless;
+    }
+
+    wnd &wnd::set_motion_history(bool enabled)
+    {
+        _motion_history = enabled;
+        if (!enabled)
+            _motion_samples.clear();
+        return *this;
+    }
+
+    const std::vector<motion_sample> &wnd::motion_history() const
+    {
+        return _motion_samples;
+    }
+
+    void wnd::on_native_motion(point p, uint32_t time)
+    {
+        // First sample of a new batch drops the previous batch's history.
+        if (!_motion_pending)
+        {
+            _motion_samples.clear();
+            _motion_pending = true;
+        }
+
+        _motion_last = p;
+        if (_motion_history)
+            _motion_samples.emplace_back(p, time);
+    }
+
+    void wnd::flush_native_motion()
+    {
+        if (!_motion_pending)
+            return;
+
+        _motion_pending = false;
+        on_mouse_move.emit(_motion_last);
+    }
+
+    wnd &wnd::scroll(const rect &r, coord dx, coord dy)
+    {
+        if (!_created || (dx == 0 && dy == 0))
+            return *this;
+
+        const auto plan = detail::plan_scroll(r, dx, dy);
+        if (!detail::scroll_backend_native(this, r, plan))
+            invalidate(r);
+        return *this;
+    }
+
+    void wnd::relayout()
+    {
+        if (!_layout)
+            return;
+
+        if (detail::layouts().deferring())
+        {
+            detail::layouts().relayout(this);
+            return;
+        }
+
+        const size d = dimensions();
+        _layout->relayout(this, rect(0, 0, d.w, d.h));
+    }
+
+    size wnd::desired_size() const
+    {
+        if (!_measured)
+        {
+            _desired = measure();
+            _measured = true;
+        }
+        return _desired;
+    }
+
+    void wnd::invalidate_measure()
+    {
+        // A laid-out parent's desired size follows its children, so the
+        // chain of laid-out ancestors is dropped and every layout in it
+        // runs again. Each one is queued: a nested window whose own cell
+        // did not move is not resized, so the layout above it would not
+        // reach it. The update runs them once each, from the top.
+        detail::layouts().begin();
+        _measured = false;
+        relayout();
+        for (wnd *w = _parent; w && w->_layout; w = w->_parent)
+        {
+            w->_measured = false;
+            w->relayout();
+        }
+        detail::layouts().end();
+    }
+
+    size wnd::measure() const
+    {
+        if (_layout)
+            return _layout->measure(this);
+        return dimensions();
+    }
+
+    size button::measure() const
+    {
+        const auto m = detail::control_paint_backend_metrics();
+        const int w = detail::control_paint_backend_text_width(_text) + m.text_padding_x * 2;
+        return size(static_cast<dim>(std::max(0, w)), static_cast<dim>(std::max(0, m.button_height)));
+    }
+
+} // namespace native
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+
+// Minimal checks for the test programs. A test is a program() that
+// returns failures() != 0; CHECK may be used from any thread.
+namespace test
+{
+    inline std::atomic<int> &failures()
+    {
+        static std::atomic<int> n{0};
+        return n;
+    }
+
+    inline bool check(bool ok, const char *what, const char *file, int line)
+    {
+        if (!ok)
+        {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+            ++failures();
+        }
+        return ok;
+    }
+}
+
+#define CHECK(cond) ::test::check((cond), #cond, __FILE__, __LINE__)
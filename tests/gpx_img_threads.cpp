@@ -0,0 +1,100 @@
+// Concurrent software rendering: one painter per thread on disjoint
+// images, get_gpx() racing on one image, and one signal per thread.
+
+#include <thread>
+#include <vector>
+
+#include <native.h>
+
+#include "check.h"
+
+using namespace native;
+
+namespace
+{
+    constexpr int threads = 8;
+
+    // Draws the same scene on any image; exercises every gpx_img primitive
+    // that keeps state, including text through the stock font.
+    void render(gpx &g)
+    {
+        g.clear(rgba(255, 255, 255, 255));
+        g.set_ink(rgba(200, 40, 40, 255)).draw_rect(rect(10, 10, 60, 40), true);
+        g.set_ink(rgba(0, 0, 0, 255)).set_pen(3).draw_line(point(0, 0), point(159, 119));
+        g.set_pen(1).draw_rect(rect(80, 20, 50, 50));
+        g.draw_text("native 0123", point(12, 90));
+
+        path p;
+        p.move_to(100, 80).line_to(150, 110).quad_to(120, 120, 90, 110).close();
+        g.set_ink(rgba(30, 90, 200, 255)).fill_path(p);
+    }
+
+    uint64_t checksum(const img &im)
+    {
+        uint64_t h = 1469598103934665603ull;
+        for (int i = 0; i < im.w() * im.h(); ++i)
+            h = (h ^ im.pixels()[i].value) * 1099511628211ull;
+        return h;
+    }
+
+    // Connects, disconnects (also from inside a slot) and emits on a
+    // signal owned by the calling thread; returns the slot calls counted.
+    int exercise_signal()
+    {
+        signal<int> s;
+        int calls = 0;
+        std::vector<int> ids;
+        for (int i = 0; i < 16; ++i)
+            ids.push_back(s.connect([&calls](int) { ++calls; return false; }));
+        for (std::size_t i = 0; i < ids.size(); i += 2)
+            s.disconnect(ids[i]);
+
+        int self = 0;
+        self = s.connect([&](int) { s.disconnect(self); return false; });
+
+        for (int i = 0; i < 1000; ++i)
+            s.emit(i);
+        return calls;
+    }
+}
+
+int program(int, char **)
+{
+    std::vector<std::unique_ptr<img>> images;
+    for (int i = 0; i < threads; ++i)
+        images.push_back(std::make_unique<img>(160, 120));
+
+    img shared(16, 16);
+    std::vector<gpx *> shared_gpx(threads);
+    std::vector<uint64_t> sums(threads);
+    std::vector<int> calls(threads);
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]
+                          {
+                              shared_gpx[t] = &shared.get_gpx();
+                              for (int k = 0; k < 20; ++k)
+                                  render(*images[t]->create_gpx());
+                              sums[t] = checksum(*images[t]);
+                              calls[t] = exercise_signal(); });
+    }
+    for (auto &th : pool)
+        th.join();
+
+    // Rendered after the threads, so they are the first to reach the
+    // stock font.
+    img reference(160, 120);
+    render(*reference.create_gpx());
+    const uint64_t expected = checksum(reference);
+
+    for (int t = 0; t < threads; ++t)
+    {
+        CHECK(sums[t] == expected);
+        CHECK(shared_gpx[t] == shared_gpx[0]);
+        CHECK(calls[t] == 8 * 1000);
+    }
+
+    return test::failures() != 0;
+}
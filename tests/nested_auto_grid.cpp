@@ -0,0 +1,85 @@
+// A grid with an auto column, nested in a grid cell whose size does not
+// change when the column's content grows. invalidate_measure() must lay
+// out the nested grid too, not only the window at the top.
+
+#include <memory>
+
+#include <native.h>
+
+#include "check.h"
+
+using namespace native;
+
+namespace
+{
+    struct box : wnd
+    {
+        size want;
+
+        explicit box(size s) : wnd(0, 0, 1, 1), want(s) {}
+        void show() const override {}
+        void create() const override {}
+        void destroy() const override {}
+
+    protected:
+        size measure() const override { return layout() ? wnd::measure() : want; }
+    };
+
+    // rest sits right of label, in the star column after it.
+    bool adjacent(const wnd &label, const wnd &rest)
+    {
+        return rest.bounds().p.x == label.bounds().p.x + label.bounds().d.w;
+    }
+}
+
+int program(int, char **)
+{
+    box host(size(400, 300));
+    box panel(size(0, 0));
+    box label(size(50, 20));
+    box rest(size(0, 20));
+
+    panel.set_parent(&host);
+    label.set_parent(&panel);
+    rest.set_parent(&panel);
+
+    // A new grid starts with one star row and column; the tracks below
+    // come after them. set_layout() places the children in order, so
+    // they are placed again in their cells.
+    auto inner = std::make_unique<grid_layout_manager>();
+    grid_layout_manager &panel_grid = *inner;
+    panel_grid << column(auto_()) << column(star());
+    panel.set_layout(std::move(inner));
+    panel_grid << cell(label, 0, 1) << cell(rest, 0, 2);
+
+    auto outer = std::make_unique<grid_layout_manager>();
+    grid_layout_manager &host_grid = *outer;
+    host_grid << row(auto_()) << row(star());
+    host.set_layout(std::move(outer));
+    host_grid << cell(panel, 1, 0);
+    host.set_bounds(rect(0, 0, 400, 300));
+
+    CHECK(panel.bounds().d.h == 20);
+    CHECK(label.bounds().d.w == 50);
+    CHECK(adjacent(label, rest));
+
+    // Same height, so the panel's cell in host stays where it was.
+    label.want = size(80, 20);
+    label.invalidate_measure();
+
+    CHECK(panel.bounds().d.h == 20);
+    CHECK(label.bounds().d.w == 80);
+    CHECK(adjacent(label, rest));
+
+    // Inside an open transaction the layouts wait for the outermost end.
+    app::begin_update();
+    label.want = size(120, 20);
+    label.invalidate_measure();
+    CHECK(label.bounds().d.w == 80);
+    app::end_update();
+
+    CHECK(label.bounds().d.w == 120);
+    CHECK(adjacent(label, rest));
+
+    return test::failures() != 0;
+}
@@ -0,0 +1,98 @@
+// Scrolls of a retained backbuffer that run before the damage they move
+// is painted. The backbuffer is modelled as one value per row, and the
+// list it shows as top + y for row y.
+
+#include <algorithm>
+#include <vector>
+
+#include <native.h>
+
+#include "check.h"
+#include "frame_scheduler.h"
+#include "scroll.h"
+
+using namespace native;
+
+namespace
+{
+    constexpr int rows = 100;
+    constexpr int width = 50;
+
+    struct model_wnd : wnd
+    {
+        model_wnd() : wnd(0, 0, width, rows) {}
+        void show() const override {}
+        void create() const override {}
+        void destroy() const override {}
+    };
+
+    std::vector<int> backbuffer(rows);
+    int top = 0;
+    int version = 0; // Bumped when the list content changes
+
+    int truth(int y) { return (top + y) * 1000 + version; }
+
+    void paint(wnd *, const rect &damage, const rect &)
+    {
+        for (int y = std::max<int>(0, damage.p.y); y < std::min<int>(rows, damage.p.y + damage.d.h); ++y)
+            backbuffer[y] = truth(y);
+    }
+
+    // What scroll_retained does, on the model instead of a gpx.
+    void scroll(wnd &w, int dy)
+    {
+        const rect r(0, 0, width, rows);
+        const auto plan = detail::plan_scroll(r, 0, dy);
+        std::vector<int> moved = backbuffer;
+        for (int y = 0; y < plan.src.d.h; ++y)
+            moved[plan.dst.y + y] = backbuffer[plan.src.p.y + y];
+        backbuffer = moved;
+        top -= dy;
+        detail::scroll_damage(&w, r, plan);
+    }
+
+    int stale_rows()
+    {
+        int n = 0;
+        for (int y = 0; y < rows; ++y)
+            n += backbuffer[y] != truth(y);
+        return n;
+    }
+}
+
+int program(int, char **)
+{
+    app::set_frame_rate(0);
+    model_wnd w;
+
+    for (int y = 0; y < rows; ++y)
+        backbuffer[y] = truth(y);
+
+    // Rows 40-59 change, then two scrolls up by 15 run before the frame.
+    ++version;
+    for (int y = 0; y < rows; ++y)
+    {
+        if (y < 40 || y >= 60)
+            backbuffer[y] = truth(y);
+    }
+    detail::frames().request(&w, rect(0, 40, width, 20));
+    scroll(w, -15);
+    scroll(w, -15);
+    detail::frames().run(paint);
+    CHECK(stale_rows() == 0);
+
+    // Same in the other direction, with the damage partly scrolled out.
+    ++version;
+    for (int y = 0; y < rows; ++y)
+    {
+        if (y < 85 || y >= 95)
+            backbuffer[y] = truth(y);
+    }
+    detail::frames().request(&w, rect(0, 85, width, 10));
+    scroll(w, 10);
+    scroll(w, 2);
+    detail::frames().run(paint);
+    CHECK(stale_rows() == 0);
+
+    return test::failures() != 0;
+}
@@ -0,0 +1,76 @@
+// A file truncated under text_index, the way copytruncate or "> file"
+// does it. Lines read before the index notices must come back short
+// instead of faulting on the stale mapping, and the file is then
+// indexed again from the start.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "check.h"
+#include "text_index.h"
+
+using namespace native;
+
+namespace
+{
+    bool write_file(const std::string &path, const std::string &text)
+    {
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (!f)
+            return false;
+        const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        return std::fclose(f) == 0 && ok;
+    }
+
+    // Waits for the worker to index everything, for up to two seconds.
+    bool settle(const detail::text_index &index, std::size_t lines)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto p = index.snapshot();
+            if (p.complete && p.lines == lines)
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+}
+
+int program(int, char **)
+{
+    char path[] = "/tmp/native-text-index-XXXXXX";
+    const int fd = mkstemp(path);
+    if (!CHECK(fd >= 0))
+        return 1;
+    close(fd);
+
+    // Several pages, so the old mapping reaches well past the new end.
+    std::string text;
+    for (int i = 0; i < 4096; ++i)
+        text += "line " + std::to_string(i) + "\r\n";
+    CHECK(write_file(path, text));
+
+    detail::text_index index;
+    CHECK(index.open(path));
+    CHECK(settle(index, 4096));
+    CHECK(index.line(4095, 4096) == "line 4095");
+    const uint64_t generation = index.snapshot().generation;
+
+    // The index still holds 4096 lines; reading them must not fault.
+    CHECK(truncate(path, 0) == 0);
+    CHECK(index.line(4095, 4096).empty());
+    CHECK(index.line(0, 4096).empty());
+
+    CHECK(write_file(path, "new\nfile\n"));
+    CHECK(settle(index, 2));
+    CHECK(index.snapshot().generation > generation);
+    CHECK(index.line(1, 4096) == "file");
+
+    index.close();
+    std::remove(path);
+    return test::failures() != 0;
+}